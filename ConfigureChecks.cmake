@@ -35,6 +35,8 @@ check_include_files(stdlib.h      LOG4CPLUS_HAVE_STDLIB_H )
 check_include_files(time.h        LOG4CPLUS_HAVE_TIME_H )
 check_include_files(wchar.h       LOG4CPLUS_HAVE_WCHAR_H )
 check_include_files(poll.h        LOG4CPLUS_HAVE_POLL_H )
+check_include_files(sys/inotify.h LOG4CPLUS_HAVE_SYS_INOTIFY_H )
+check_include_files(sys/eventfd.h LOG4CPLUS_HAVE_SYS_EVENTFD_H )
 
 
 check_include_files(inttypes.h    HAVE_INTTYPES_H )
@@ -67,6 +69,7 @@ check_function_exists(poll          LOG4CPLUS_HAVE_POLL )
 check_function_exists(pipe          LOG4CPLUS_HAVE_PIPE )
 check_function_exists(pipe2         LOG4CPLUS_HAVE_PIPE2 )
 check_function_exists(accept4       LOG4CPLUS_HAVE_ACCEPT4 )
+check_function_exists(memfd_create  LOG4CPLUS_HAVE_MEMFD_CREATE )
 check_function_exists(ftime         LOG4CPLUS_HAVE_FTIME )
 check_function_exists(stat          LOG4CPLUS_HAVE_STAT )
 check_function_exists(lstat         LOG4CPLUS_HAVE_LSTAT )
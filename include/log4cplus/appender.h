@@ -36,11 +36,14 @@
 #include <log4cplus/helpers/pointer.h>
 #include <log4cplus/spi/filter.h>
 #include <log4cplus/helpers/lockfile.h>
+#include <log4cplus/helpers/snapshot.h>
 
 #include <memory>
 #include <mutex>
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <chrono>
 
 
 namespace log4cplus {
@@ -54,6 +57,48 @@ namespace log4cplus {
     }
 
 
+    namespace internal
+    {
+
+        struct AsyncStrand;
+
+    }
+
+
+    /**
+     * What an asynchronous appender does with an event that does not fit
+     * into its full queue.
+     */
+    enum class AsyncOverflowPolicy
+    {
+        //! Wait until there is room in the queue.
+        block,
+        //! Wait at most AsyncOverflow::timeout, then drop the event.
+        block_timeout,
+        //! Drop the event.
+        drop_newest,
+        //! Drop the oldest queued event to make room for the event.
+        drop_oldest,
+        //! Drop the event if it is less severe than AsyncOverflow::level.
+        //! Otherwise drop the oldest queued less severe event to make
+        //! room, or wait if there is none.
+        drop_below_level,
+        //! Append the event synchronously by the logging thread.
+        synchronous
+    };
+
+
+    //! Overflow handling of an asynchronous appender.
+    struct AsyncOverflow
+    {
+        AsyncOverflowPolicy policy = AsyncOverflowPolicy::block;
+        //! Used by AsyncOverflowPolicy::block_timeout.
+        std::chrono::milliseconds timeout {0};
+        //! Used by AsyncOverflowPolicy::drop_below_level.
+        LogLevel level = WARN_LOG_LEVEL;
+    };
+
+
     /**
      * This class is used to "handle" errors encountered in an {@link
      * log4cplus::Appender}.
@@ -132,6 +177,31 @@ namespace log4cplus {
      * <dd>Set this property to <tt>true</tt> if you want all appends using
      * this appender to be done asynchronously. Default is <tt>false</tt>.</dd>
      *
+     * <dt><tt>OverflowPolicy</tt></dt>
+     * <dd>What to do with events that do not fit into the full queue
+     * when appending asynchronously: <tt>Block</tt>,
+     * <tt>BlockTimeout</tt>, <tt>DropNewest</tt>, <tt>DropOldest</tt>,
+     * <tt>DropBelowLevel</tt> or <tt>Synchronous</tt>, see
+     * AsyncOverflowPolicy. Without it, the appender blocks or drops the
+     * events as set by the <tt>log4cplus.threadPoolBlockOnFull</tt>
+     * property.</dd>
+     *
+     * <dt><tt>OverflowTimeout</tt></dt>
+     * <dd>Number of milliseconds to wait with <tt>BlockTimeout</tt>
+     * policy. Default is 0.</dd>
+     *
+     * <dt><tt>OverflowLevel</tt></dt>
+     * <dd>Events at or above this log level are kept with
+     * <tt>DropBelowLevel</tt> policy. Default is <tt>WARN</tt>.</dd>
+     *
+     * <dt><tt>ConcurrentFormatting</tt></dt>
+     * <dd>Set this property to <tt>true</tt> if you want the threshold,
+     * the filters and the layout to be evaluated by the logging thread
+     * before it takes the appender's lock. Only writing of the already
+     * formatted event is then serialized. The layout must not be
+     * replaced while logging in this mode. Default is
+     * <tt>false</tt>.</dd>
+     *
      * </dl>
      */
     class LOG4CPLUS_EXPORT Appender
@@ -173,6 +243,10 @@ namespace log4cplus {
          * This method performs threshold checks and invokes filters before
          * delegating actual logging to the subclasses specific {@link
          * #append} method.
+         *
+         * With concurrent formatting enabled, the checks and the
+         * formatting of the event by the layout are done before the
+         * appender's lock is taken, see {@link #setConcurrentFormatting}.
          */
         void syncDoAppend(const log4cplus::spi::InternalLoggingEvent& event);
 
@@ -185,8 +259,10 @@ namespace log4cplus {
 
         /**
          * This function checks `async` flag. It either executes
-         * `syncDoAppend()` directly or enqueues its execution to thread pool
-         * thread.
+         * `syncDoAppend()` directly or queues the event for execution on
+         * a thread pool thread. Queued events of one appender are
+         * appended by at most one thread at a time, in the order in which
+         * they were queued.
          */
         void doAppend(const log4cplus::spi::InternalLoggingEvent& event);
 
@@ -228,7 +304,9 @@ namespace log4cplus {
         virtual Layout* getLayout();
 
         /**
-         * Set the filter chain on this Appender.
+         * Set the filter chain on this Appender. The chain is compiled,
+         * see spi::CompiledFilterChain, changes made to it later are
+         * not seen until it is set again.
          */
         void setFilter(log4cplus::spi::FilterPtr f);
 
@@ -279,6 +357,60 @@ namespace log4cplus {
          */
         void waitToFinishAsyncLogging();
 
+        /**
+         * Sets what happens to events that do not fit into the full queue
+         * of this appender when it appends asynchronously.
+         */
+        void setAsyncOverflow(AsyncOverflow const & overflow);
+
+        /**
+         * Returns overflow handling set by {@link #setAsyncOverflow}.
+         * Without it, the policy is AsyncOverflowPolicy::block or
+         * AsyncOverflowPolicy::drop_newest as set by
+         * log4cplus::setThreadPoolBlockOnFull().
+         */
+        AsyncOverflow getAsyncOverflow() const;
+
+        /**
+         * Returns number of events dropped by this appender because its
+         * asynchronous queue was full.
+         */
+        std::uint64_t getDroppedEventCount() const
+        { return droppedEvents.load (std::memory_order_relaxed); }
+
+        /**
+         * Enables formatting of events outside of the appender's lock.
+         * The event is formatted into a thread local buffer and {@link
+         * #append} only writes the buffer out. Appenders which do not
+         * format through {@link #formatEvent} or {@link
+         * #formatAndAppend}, see {@link #usesFormattedEvent}, still
+         * format under the lock.
+         */
+        void setConcurrentFormatting(bool concurrent)
+        { concurrentFormatting = concurrent; }
+
+        bool getConcurrentFormatting() const { return concurrentFormatting; }
+
+        /**
+         * Returns the set of optional event fields, see
+         * spi::EventField, that this appender reads, including fields
+         * read by its layout and filters. Loggers capture only fields
+         * that some of their appenders read and asynchronous appending
+         * copies only these.
+         *
+         * The default is all fields. Appenders which only pass events
+         * to their layout and filters return {@link
+         * #getLayoutEventFields}.
+         */
+        virtual unsigned getEventFields() const;
+
+        /**
+         * Returns a counter which is incremented whenever layout or
+         * filters of any appender change, which can change the result
+         * of {@link #getEventFields}.
+         */
+        static std::uint64_t getEventFieldsEpoch();
+
     protected:
       // Methods
         /**
@@ -290,6 +422,43 @@ namespace log4cplus {
 
         tstring & formatEvent (const log4cplus::spi::InternalLoggingEvent& event) const;
 
+        /**
+         * Returns `true` if {@link #append} formats events only through
+         * {@link #formatEvent} or {@link #formatAndAppend}. Only events
+         * of such appenders are formatted before the lock is taken with
+         * concurrent formatting enabled, other appenders would format
+         * them again. The default is `false`.
+         */
+        virtual bool usesFormattedEvent() const { return false; }
+
+        //! Returns overflow handling set by setAsyncOverflow() or
+        //! `fallback` if there is none.
+        AsyncOverflow getAsyncOverflowOr(AsyncOverflow const & fallback)
+            const;
+
+        //! Counts an event dropped because of full asynchronous queue
+        //! and occasionally warns about it.
+        void recordDroppedEvent();
+
+        /**
+         * Writes the event formatted by the layout into `output`. This
+         * uses the output formatted ahead by {@link #syncDoAppend} when
+         * there is one for the event, or the output of an equivalent
+         * layout of another appender that the event is being dispatched
+         * to.
+         */
+        void formatAndAppend (log4cplus::tostream & output,
+            const log4cplus::spi::InternalLoggingEvent& event) const;
+
+        //! Returns event fields read by the layout and by the filters.
+        unsigned getLayoutEventFields() const
+        { return layoutEventFields.load (std::memory_order_relaxed); }
+
+        //! Recomputes getLayoutEventFields() and increments
+        //! getEventFieldsEpoch(). Appenders overriding getEventFields()
+        //! call this when its result changes.
+        void updateEventFields();
+
       // Data
         /** The layout variable does not need to be set if the appender
          *  implementation has its own layout. */
@@ -317,19 +486,50 @@ namespace log4cplus {
 
         //! Asynchronous append.
         bool async;
+        //! Format events before taking `access_mutex`.
+        bool concurrentFormatting;
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
         std::atomic<std::size_t> in_flight;
         std::mutex in_flight_mutex;
         std::condition_variable in_flight_condition;
+        //! Events queued for asynchronous append.
+        std::unique_ptr<internal::AsyncStrand> strand;
 #endif
 
         /** Is this appender closed? */
         bool closed;
 
     private:
+      // Types
+        //! Immutable compiled view of the filter chain, published on each
+        //! change of it, so that filters can be evaluated without
+        //! `access_mutex`.
+        struct FilterSnapshot
+        {
+            log4cplus::spi::CompiledFilterChain chain;
+        };
+
+      // Methods
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
         void subtract_in_flight();
+        void queueAsyncDoAppend(
+            const log4cplus::spi::InternalLoggingEvent& event);
+        void scheduleAsyncStrand();
+        void drainAsyncStrand();
+        bool appendAsyncBatch();
 #endif
+        void concurrentDoAppend(
+            const log4cplus::spi::InternalLoggingEvent& event);
+        tstring const * getSharedFormat(
+            const log4cplus::spi::InternalLoggingEvent& event) const;
+        void appendLocked(const log4cplus::spi::InternalLoggingEvent& event);
+
+      // Data
+        helpers::AtomicSnapshot<FilterSnapshot> filterSnapshot;
+        std::atomic<unsigned> layoutEventFields;
+        //! Null until setAsyncOverflow() is called.
+        helpers::AtomicSnapshot<AsyncOverflow> asyncOverflow;
+        std::atomic<std::uint64_t> droppedEvents {0};
     };
 
     /** This is a pointer to an Appender. */
@@ -59,6 +59,16 @@ namespace log4cplus
    attached appendres are then appended to from a separate thread which reads
    events appended to this appender from a queue.
 
+   When the queue is full, events are handled according to the appender's
+   <tt>OverflowPolicy</tt>, see Appender::setAsyncOverflow(). Without it,
+   the appender waits for room in the queue.
+
+   Property <tt>PriorityLevel</tt> puts events at or above the given log
+   level into a priority lane that is appended before the backlog of
+   other events, see setPriorityLane(). Property <tt>MergeLanes</tt> set
+   to <tt>true</tt> keeps timestamp order within each batch of events
+   taken from the queue.
+
    \sa helpers::AppenderAttachableImpl
  */
 class LOG4CPLUS_EXPORT AsyncAppender
@@ -76,6 +86,10 @@ public:
 
     virtual void close () override;
 
+    //! Makes events at or above `level` bypass the backlog of less
+    //! severe events. See thread::Queue::set_priority_lane().
+    void setPriorityLane (LogLevel level, bool merge = false);
+
 protected:
     virtual void append (spi::InternalLoggingEvent const &) override;
 
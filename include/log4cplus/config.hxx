@@ -170,6 +170,7 @@
 
 #if defined(__cplusplus)
 #include <cstddef>
+#include <chrono>
 
 namespace log4cplus
 {
@@ -191,15 +192,46 @@ LOG4CPLUS_EXPORT void initialize ();
 //! \note using `log4cplus::Initializer` is preferred
 LOG4CPLUS_EXPORT void deinitialize ();
 
-//! Set thread pool size.
+//! Set fixed thread pool size. This is the same as setting both minimal
+//! and maximal size to `pool_size`.
 LOG4CPLUS_EXPORT void setThreadPoolSize (std::size_t pool_size);
 
-//! Set behaviour on full thread pool queue. Default is to block.
+//! Set minimal thread pool size. The thread pool is created with this
+//! many threads on first asynchronous use and never shrinks below it.
+//! Default is 1.
+LOG4CPLUS_EXPORT void setThreadPoolMinSize (std::size_t min_size);
+
+//! Set maximal thread pool size the thread pool can grow to under load.
+//! Default is number of hardware threads but at least 4.
+LOG4CPLUS_EXPORT void setThreadPoolMaxSize (std::size_t max_size);
+
+//! Set how long the thread pool has to be without backlog before it
+//! starts releasing threads above its minimal size. Default is 60 seconds.
+LOG4CPLUS_EXPORT void setThreadPoolIdleTimeout (
+    std::chrono::milliseconds idle_timeout);
+
+//! Set when the thread pool adds a thread: when more than `queue_depth`
+//! asynchronous appenders per thread wait for a thread or when one of them
+//! has waited longer than `latency`. Defaults are 2 appenders and 10
+//! milliseconds.
+LOG4CPLUS_EXPORT void setThreadPoolScaleUpThresholds (std::size_t queue_depth,
+    std::chrono::milliseconds latency);
+
+//! Set behaviour on full queue of an asynchronous appender. Default is to
+//! block.
 LOG4CPLUS_EXPORT void setThreadPoolBlockOnFull (bool block);
 
-//! Set thread pool queue size limit.
+//! Set limit of events queued by each asynchronous appender. Default is
+//! 100000.
 LOG4CPLUS_EXPORT void setThreadPoolQueueSizeLimit (std::size_t queue_size_limit);
 
+//! Set limit of tasks queued in the thread pool. Each asynchronous
+//! appender queues at most one task at a time, so this bounds number of
+//! appenders waiting for a thread rather than number of events. Default
+//! is the limit of the thread pool itself.
+LOG4CPLUS_EXPORT void setThreadPoolTaskQueueSizeLimit (
+    std::size_t task_queue_size_limit);
+
 } // namespace log4cplus
 
 #endif
@@ -148,6 +148,18 @@ namespace log4cplus
          * log4cplus.appender.appenderName.layout.option&lt;N&gt;=value&lt;N&gt;
          * </pre>
          *
+         * Appenders are created while the configuration is read, which
+         * opens their files, connects their sockets, etc. With
+         * <tt>log4cplus.appender.appenderName.Activation=Lazy</tt> the
+         * appender is created only when the first event that passes its
+         * <tt>Threshold</tt> and <tt>filters</tt> is dispatched to it.
+         * Appenders that never receive any event then cost nothing. The
+         * default is <tt>Eager</tt>. Errors in configuration of lazy
+         * appenders are reported only on their activation. Loggers hold a
+         * stand-in for a lazy appender, not the appender itself, so
+         * <code>Logger::getAppender()</code> returns the stand-in. Use
+         * getActivatedAppender() to get the real appender.
+         *
          * <h3>Configuring loggers</h3>
          *
          * The syntax for configuring the root logger is:
@@ -201,16 +213,36 @@ namespace log4cplus
          * <h3>Global configuration</h3>
          *
          * <ul>
-         * <li>Property <pre>log4cplus.threadPoolSize</pre> can be used to adjust
-         * size of log4cplus' internal thread pool.</li>
+         * <li>Property <pre>log4cplus.threadPoolSize</pre> can be used to fix
+         * size of log4cplus' internal thread pool. Without it, the thread
+         * pool is created on first asynchronous use and scales between
+         * its minimal and maximal size with load.</li>
+         * <li>Properties <pre>log4cplus.threadPoolMinSize</pre> and
+         * <pre>log4cplus.threadPoolMaxSize</pre> set the bounds of the
+         * thread pool size. Defaults are 1 and number of hardware threads
+         * but at least 4.</li>
+         * <li>Property <pre>log4cplus.threadPoolIdleTimeout</pre> sets
+         * number of seconds without backlog after which the thread pool
+         * starts releasing threads above its minimal size. Default is 60.</li>
+         * <li>Properties <pre>log4cplus.threadPoolScaleUpQueueDepth</pre>
+         * and <pre>log4cplus.threadPoolScaleUpLatency</pre> set number of
+         * asynchronous appenders per thread waiting for a thread and number
+         * of milliseconds one can wait before the thread pool adds a
+         * thread. Defaults are 2 and 10.</li>
          * <li>Property <pre>log4cplus.threadPoolBlockOnFull</pre> can be
-         * used to change behaviour of the thread pool when its queue is full.
-         * The default value is <pre>true</pre>, to block the thread until
-         * there is a space in the queue. Setting this property to
-         * <pre>false</pre> makes the thread pool not to block when it is full.
-         * The items that could not be inserted are dropped instead.</li>
+         * used to change behaviour of asynchronous appenders when their
+         * queue is full. The default value is <pre>true</pre>, to block the
+         * thread until there is a space in the queue. Setting this property
+         * to <pre>false</pre> makes the appenders not to block when full.
+         * The events that could not be queued are dropped instead.
+         * Appenders with <pre>OverflowPolicy</pre> property follow their
+         * own policy, see Appender.</li>
          * <li>Property <pre>log4cplus.threadPoolQueueSizeLimit</pre> can be used to
-         * set thread pool queue size limit.</li>
+         * set limit of events queued by each asynchronous appender.</li>
+         * <li>Property <pre>log4cplus.threadPoolTaskQueueSizeLimit</pre>
+         * can be used to set limit of tasks queued in the thread pool.
+         * Each asynchronous appender has at most one task queued at a
+         * time.</li>
          * </ul>
          *
          * <h3>Example</h3>
@@ -291,14 +323,28 @@ namespace log4cplus
          */
         log4cplus::tstring const & getPropertyFilename () const;
 
+        /**
+         * Returns the real appender behind a stand-in of an appender
+         * configured with <tt>Activation=Lazy</tt>, activating it if it
+         * has not been activated yet. Other appenders are returned as
+         * they are.
+         *
+         * \return Empty pointer if the real appender cannot be created.
+         */
+        static log4cplus::SharedAppenderPtr getActivatedAppender (
+            log4cplus::SharedAppenderPtr const & appender);
+
     protected:
       // Methods
         void init();  // called by the ctor
+        void configureInternals();
         void reconfigure();
         void replaceEnvironVariables();
         void configureLoggers();
         void configureLogger(log4cplus::Logger logger, const log4cplus::tstring& config);
         void configureAppenders();
+        void configureAppender(const log4cplus::tstring& appenderName,
+            const log4cplus::helpers::Properties& appenderProperties);
         void configureAdditivity();
 
         virtual Logger getLogger(const log4cplus::tstring& name);
@@ -364,6 +410,17 @@ namespace log4cplus
     class ConfigurationWatchDogThread;
 
 
+    /**
+     * Watches a properties file and applies its changes incrementally
+     * when it is modified.
+     *
+     * Levels of loggers, their dispatch lists and filter chains of
+     * appenders are each replaced on their own, without blocking
+     * logging threads. A reconfiguration is therefore not applied
+     * atomically: while it is in progress, events logged through one
+     * logger can already see the new configuration while events logged
+     * through another logger still see the old one.
+     */
     class LOG4CPLUS_EXPORT ConfigureAndWatchThread {
     public:
       // ctor and dtor
@@ -80,6 +80,7 @@ namespace log4cplus {
 
       // Methods
         virtual void close() override;
+        virtual unsigned getEventFields() const override;
 
         //! This mutex is used by ConsoleAppender and helpers::LogLog
         //! classes to synchronize output to console.
@@ -87,6 +88,7 @@ namespace log4cplus {
 
     protected:
         virtual void append(const spi::InternalLoggingEvent& event) override;
+        virtual bool usesFormattedEvent() const override { return true; }
 
       // Data
         bool logToStdErr;
@@ -0,0 +1,131 @@
+// -*- C++ -*-
+//  Copyright (C) 2026, log4cplus contributors. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+/** @file */
+
+#ifndef LOG4CPLUS_DEDUPLICATION_APPENDER_HEADER_
+#define LOG4CPLUS_DEDUPLICATION_APPENDER_HEADER_
+
+#include <log4cplus/config.hxx>
+
+#if defined (LOG4CPLUS_HAVE_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <log4cplus/appender.h>
+#include <log4cplus/helpers/appenderattachableimpl.h>
+#include <chrono>
+#include <memory>
+
+
+namespace log4cplus {
+
+/**
+ * This `Appender` is a wrapper which collapses repeated events. The
+ * first event of each fingerprint is appended to the attached
+ * appenders, repeats of it within the following window are counted and
+ * dropped. Once the window closes, a single event with message
+ * "Message repeated N times: <message>" is appended instead of the
+ * repeats.
+ *
+ * <h3>Properties</h3>
+ * <dl>
+ * <dt><tt>Appender</tt></dt>
+ * <dd>Name of the appender factory of the attached appender. Its
+ * properties are given as <tt>Appender.</tt> sub-properties, like for
+ * AsyncAppender.</dd>
+ *
+ * <dt><tt>Key</tt></dt>
+ * <dd>Either <tt>Message</tt>, the default, which fingerprints events
+ * by logger, log level and message, or <tt>CallSite</tt>, which
+ * fingerprints events by logger, log level, file and line.</dd>
+ *
+ * <dt><tt>Window</tt></dt>
+ * <dd>Length of the window in seconds. Default is 10.</dd>
+ *
+ * <dt><tt>MaxEntries</tt></dt>
+ * <dd>Maximum number of fingerprints tracked at the same time. When
+ * the limit is reached, the window which started first is closed
+ * early. Default is 1024.</dd>
+ * </dl>
+ *
+ * A background thread closes windows as they expire, so that the
+ * summary of a burst does not wait for the next event. It only wakes
+ * up while some window is open. Windows are also closed when an event
+ * is appended and when the appender is closed.
+ *
+ * \sa helpers::AppenderAttachableImpl
+ */
+class LOG4CPLUS_EXPORT DeduplicationAppender
+    : public Appender
+    , public helpers::AppenderAttachableImpl
+{
+public:
+    //! What the fingerprint of an event consists of.
+    enum class Key { MESSAGE, CALL_SITE };
+
+    DeduplicationAppender (SharedAppenderPtr const & app,
+        std::chrono::steady_clock::duration window,
+        Key key = Key::MESSAGE, unsigned maxEntries = 1024);
+    DeduplicationAppender (helpers::Properties const &);
+
+    DeduplicationAppender (DeduplicationAppender const &) = delete;
+    DeduplicationAppender & operator = (DeduplicationAppender const &)
+        = delete;
+
+    virtual ~DeduplicationAppender ();
+
+    /**
+     * Closes all open windows, appending their summaries, and
+     * removes the attached appenders.
+     */
+    virtual void close () override;
+
+protected:
+    virtual void append (spi::InternalLoggingEvent const &) override;
+
+private:
+  // Types
+    //! Open windows, see deduplicationappender.cxx.
+    struct State;
+
+  // Methods
+    LOG4CPLUS_PRIVATE void init (std::chrono::steady_clock::duration window,
+        Key key, unsigned maxEntries);
+    LOG4CPLUS_PRIVATE void init_timer_thread ();
+
+  // Data
+    std::unique_ptr<State> state;
+};
+
+
+typedef helpers::SharedObjectPtr<DeduplicationAppender>
+    DeduplicationAppenderPtr;
+
+
+} // end namespace log4cplus
+
+#endif // LOG4CPLUS_DEDUPLICATION_APPENDER_HEADER_
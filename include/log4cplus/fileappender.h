@@ -126,6 +126,8 @@ namespace log4cplus
       //! \return Locale imbued in fstream.
         virtual std::locale getloc () const;
 
+        virtual unsigned getEventFields() const override;
+
     protected:
       // Ctors
         FileAppenderBase(const log4cplus::tstring& filename,
@@ -138,6 +140,7 @@ namespace log4cplus
         void init();
 
         virtual void append(const spi::InternalLoggingEvent& event) override;
+        virtual bool usesFormattedEvent() const override { return true; }
 
         virtual void open(std::ios_base::openmode mode);
         bool reopen();
@@ -325,6 +328,7 @@ namespace log4cplus
 
       // Methods
         virtual void close() override;
+        virtual unsigned getEventFields() const override;
 
     protected:
         virtual void append(const spi::InternalLoggingEvent& event) override;
@@ -397,6 +401,9 @@ namespace log4cplus
       // Dtor
         ~TimeBasedRollingFileAppender();
 
+      // Methods
+        virtual unsigned getEventFields() const override;
+
     protected:
         virtual void append(const spi::InternalLoggingEvent& event) override;
         void open(std::ios_base::openmode mode) override;
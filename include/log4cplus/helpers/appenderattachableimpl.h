@@ -32,6 +32,7 @@
 
 #include <log4cplus/tstring.h>
 #include <log4cplus/helpers/pointer.h>
+#include <log4cplus/helpers/snapshot.h>
 #include <log4cplus/spi/appenderattachable.h>
 #include <log4cplus/thread/syncprims.h>
 
@@ -44,12 +45,21 @@ namespace log4cplus {
 
         /**
          * This Interface is for attaching Appenders to objects.
+         *
+         * The list of appenders is published as an immutable snapshot,
+         * see AtomicSnapshot. {@link #appendLoopOnAppenders} iterates the
+         * current snapshot under EpochGuard, without taking any lock or
+         * touching a shared reference count. Modifications are
+         * serialized by <code>appender_list_mutex</code>; each of them
+         * copies the list and atomically replaces the snapshot.
          */
         class LOG4CPLUS_EXPORT AppenderAttachableImpl
             : public log4cplus::spi::AppenderAttachable
         {
         public:
           // Data
+            //! Serializes modifications of the list of appenders. Readers
+            //! of the list do not take it.
             thread::Mutex appender_list_mutex;
 
           // Ctors
@@ -111,8 +121,8 @@ namespace log4cplus {
             typedef std::vector<SharedAppenderPtr> ListType;
 
           // Data
-            /** Array of appenders. */
-            ListType appenderList;
+            /** Current snapshot of array of appenders. Null when empty. */
+            AtomicSnapshot<ListType> appenderList;
         };  // end class AppenderAttachableImpl
 
     } // end namespace helpers
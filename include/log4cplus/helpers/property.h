@@ -32,6 +32,7 @@
 
 #include <log4cplus/streams.h>
 #include <log4cplus/tstring.h>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -124,7 +125,8 @@ namespace log4cplus {
             /**
              * Returns a subset of the "properties" whose keys start with
              * "prefix".  The returned "properties" have "prefix" trimmed from
-             * their keys.
+             * their keys. The keys are kept ordered, so this takes
+             * O(log n + k) for k matching keys of n.
              */
             Properties getPropertySubset(const log4cplus::tstring& prefix) const;
 
@@ -137,7 +139,8 @@ namespace log4cplus {
 
         protected:
           // Types
-            typedef std::map<log4cplus::tstring, log4cplus::tstring> StringMap;
+            typedef std::map<log4cplus::tstring, log4cplus::tstring,
+                std::less<>> StringMap;
 
           // Methods
             void init(log4cplus::tistream& input);
@@ -160,10 +163,18 @@ namespace log4cplus {
         class LogLog;
 
 
+        /**
+         * Values of environment variables looked up by substVars(). The
+         * environment does not change while configuration is being read,
+         * so one cache can be shared by all substVars() calls for it.
+         */
+        typedef std::map<tstring, tstring, std::less<>> SubstVarsCache;
+
+
         bool
         substVars (tstring & dest, const tstring & val,
             Properties const & props, LogLog& loglog,
-            unsigned flags);
+            unsigned flags, SubstVarsCache * cache = nullptr);
     } // end namespace helpers
 
 }
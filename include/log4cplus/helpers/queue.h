@@ -39,7 +39,11 @@
 #include <log4cplus/thread/syncprims.h>
 
 
-namespace log4cplus { namespace thread {
+namespace log4cplus {
+
+struct AsyncOverflow;
+
+namespace thread {
 
 
 //! Single consumer, multiple producers queue.
@@ -77,12 +81,28 @@ public:
     //! \return Flags.
     flags_type put_event (spi::InternalLoggingEvent const & ev);
 
+    //! Same as above but when the queue is full, the event is handled
+    //! according to `overflow`. DROPPED flag is set in return value if
+    //! the event or another queued event has been dropped. FULL flag is
+    //! set if the event has not been queued and the caller should append
+    //! it itself, see AsyncOverflowPolicy::synchronous.
+    flags_type put_event (spi::InternalLoggingEvent const & ev,
+        AsyncOverflow const & overflow);
+
     //! Sets EXIT flag and DRAIN flag and sets internal event object
     //! into signaled state.
     //! \param drain If true, DRAIN flag will be set, otherwise unset.
     //! \return Flags, ERROR_BIT can be set upon error.
     flags_type signal_exit (bool drain = true);
 
+    //! Puts events at or above `level` into a separate priority lane.
+    //! The consumer receives all events waiting in the priority lane
+    //! first and the other events in batches of limited size, so that
+    //! priority events do not wait behind the whole backlog. If `merge`
+    //! is true, events of each batch are ordered by their timestamps
+    //! instead of priority events coming first.
+    void set_priority_lane (LogLevel level, bool merge = false);
+
     // Consumer's methods.
 
     //! The get_events() function is used by queue's consumer. It
@@ -128,14 +148,34 @@ public:
 
         //! ERROR_AFTER signals error that has occurred after queue has
         //! already been touched.
-        ERROR_AFTER = 0x0020
+        ERROR_AFTER = 0x0020,
+
+        //! DROPPED is set in return value of put_event() if an event has
+        //! been dropped because the queue was full.
+        DROPPED     = 0x0040,
+
+        //! FULL is set in return value of put_event() if the event has
+        //! not been queued because the queue was full.
+        FULL        = 0x0080
     };
 
 protected:
     //! Queue storage.
     queue_storage_type queue;
 
-    //! Mutex protecting queue and flags.
+    //! Storage of events at or above `priority_level`.
+    queue_storage_type priority_queue;
+
+    //! Enables the priority lane.
+    bool priority_lane;
+
+    //! Minimal log level of events in the priority lane.
+    LogLevel priority_level;
+
+    //! Order events of a batch by timestamp.
+    bool merge_lanes;
+
+    //! Mutex protecting queues and flags.
     Mutex mutex;
 
     //! Event on which consumer can wait if it finds queue empty.
@@ -146,6 +186,15 @@ protected:
 
     //! State flags.
     flags_type flags;
+
+private:
+    //! Returns the lane `ev` belongs to. Caller holds `mutex`.
+    queue_storage_type & lane_of (spi::InternalLoggingEvent const & ev);
+
+    //! Moves priority events and a batch of other events into `buf`.
+    //! Caller holds `mutex`.
+    //! \return Number of events moved.
+    std::size_t take_batch (queue_storage_type * buf);
 };
 
 
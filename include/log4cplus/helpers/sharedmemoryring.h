@@ -0,0 +1,122 @@
+// -*- C++ -*-
+//  Copyright (C) 2026, log4cplus contributors. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/** @file */
+
+#ifndef LOG4CPLUS_HELPERS_SHARED_MEMORY_RING_HEADER_
+#define LOG4CPLUS_HELPERS_SHARED_MEMORY_RING_HEADER_
+
+#include <log4cplus/config.hxx>
+
+#if defined (LOG4CPLUS_HAVE_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+
+#include <log4cplus/helpers/socket.h>
+
+
+namespace log4cplus::helpers {
+
+
+/**
+ * Single producer, single consumer ring of records in memory shared
+ * between two processes on the same host.
+ *
+ * The producer creates the ring in a sealed `memfd` and passes it,
+ * together with two `eventfd` doorbells, to the consumer over a
+ * connected local stream socket with offer(). The consumer takes them
+ * over with accept(). Records are copied into the ring once and the
+ * consumer reads them in place. The doorbells are rung only when the
+ * other side is waiting for data or for space. The socket stays
+ * connected for the lifetime of the ring; either side notices that the
+ * other one has gone away when it is closed.
+ *
+ * The ring refers to the socket it has been created with, the socket
+ * has to outlive it.
+ *
+ * This is available only on Linux. Elsewhere offer() and accept()
+ * return closed rings.
+ */
+class LOG4CPLUS_EXPORT SharedMemoryRing
+{
+public:
+    SharedMemoryRing ();
+    SharedMemoryRing (SharedMemoryRing &&) LOG4CPLUS_NOEXCEPT;
+    ~SharedMemoryRing ();
+
+    SharedMemoryRing & operator = (SharedMemoryRing &&) LOG4CPLUS_NOEXCEPT;
+
+    SharedMemoryRing (SharedMemoryRing const &) = delete;
+    SharedMemoryRing & operator = (SharedMemoryRing const &) = delete;
+
+    /**
+     * Creates a ring with at least `capacity` bytes of space for records
+     * and hands it over to the consumer connected through `peer`.
+     */
+    static SharedMemoryRing offer (Socket & peer, std::size_t capacity);
+
+    /**
+     * Takes over a ring offered by the producer connected through
+     * `peer`.
+     */
+    static SharedMemoryRing accept (Socket & peer);
+
+    bool isOpen () const;
+    void close ();
+
+    /**
+     * Producer side. Copies `buffers` into the ring as a single record.
+     * Blocks while there is not enough space in the ring.
+     *
+     * @return false if the record cannot ever fit or if the consumer
+     * has gone away.
+     */
+    bool write (std::size_t bufferCount,
+        SocketBuffer const * const * buffers);
+
+    /**
+     * Consumer side. Waits for the next record and points `data` and
+     * `size` at it in the shared memory. The record stays valid until
+     * the next call.
+     *
+     * @return false once the producer has gone away and the ring is
+     * empty, or if the ring is found corrupted.
+     */
+    bool read (char * & data, std::size_t & size);
+
+private:
+    struct Impl;
+
+    explicit SharedMemoryRing (std::unique_ptr<Impl>);
+
+    std::unique_ptr<Impl> impl;
+};
+
+
+} // namespace log4cplus::helpers
+
+#endif // LOG4CPLUS_HELPERS_SHARED_MEMORY_RING_HEADER_
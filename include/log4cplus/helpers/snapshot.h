@@ -0,0 +1,131 @@
+// -*- C++ -*-
+//  Copyright (C) 2026, log4cplus contributors. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+/** @file */
+
+#ifndef LOG4CPLUS_HELPERS_SNAPSHOT_HEADER_
+#define LOG4CPLUS_HELPERS_SNAPSHOT_HEADER_
+
+#include <log4cplus/config.hxx>
+
+#if defined (LOG4CPLUS_HAVE_PRAGMA_ONCE)
+#pragma once
+#endif
+
+#include <atomic>
+#include <memory>
+
+
+namespace log4cplus::helpers {
+
+
+/**
+ * Marks the calling thread as a reader of snapshots published through
+ * AtomicSnapshot for the lifetime of this object. A snapshot replaced
+ * while the guard exists is not destroyed before the guard is gone.
+ * Guards nest; only the outermost one has any cost beyond a counter.
+ *
+ * Entering and leaving the guard touches only memory of the calling
+ * thread, so readers neither block nor contend with each other or with
+ * writers.
+ */
+class LOG4CPLUS_EXPORT EpochGuard
+{
+public:
+    EpochGuard ();
+    ~EpochGuard ();
+
+    EpochGuard (EpochGuard const &) = delete;
+    EpochGuard & operator = (EpochGuard const &) = delete;
+};
+
+
+/**
+ * Hands `ptr` over to epoch based reclamation. `deleter` is called with
+ * `ptr` once every EpochGuard that existed at the time of this call is
+ * gone. That happens either right away, within this call, or when the
+ * last such guard is destroyed.
+ */
+LOG4CPLUS_EXPORT void retireSnapshot (void const * ptr,
+    void (* deleter) (void const *));
+
+
+/**
+ * Atomically replaceable pointer to an immutable object. Readers load the
+ * current snapshot under EpochGuard without taking any lock or touching
+ * a shared reference count. Writers build a new snapshot on the side and
+ * publish it with store(); the previous snapshot is retired and destroyed
+ * once in-flight readers are done with it.
+ */
+template <typename T>
+class AtomicSnapshot
+{
+public:
+    AtomicSnapshot () = default;
+
+    ~AtomicSnapshot ()
+    {
+        delete ptr.load (std::memory_order_relaxed);
+    }
+
+    AtomicSnapshot (AtomicSnapshot const &) = delete;
+    AtomicSnapshot & operator = (AtomicSnapshot const &) = delete;
+
+    //! Returns current snapshot or null. The caller has to hold
+    //! EpochGuard for as long as it uses the returned object.
+    T const * load () const noexcept
+    {
+        return ptr.load (std::memory_order_seq_cst);
+    }
+
+    //! Publishes `snapshot` and retires the previous one.
+    void store (std::unique_ptr<T const> snapshot)
+    {
+        if (T const * const old = ptr.exchange (snapshot.release (),
+                std::memory_order_seq_cst))
+            retireSnapshot (old, &destroy);
+    }
+
+    //! Publishes `snapshot` and returns the previous one. Readers may
+    //! still be using it, so the caller has to pass it to
+    //! retireSnapshot(), possibly along with other snapshots at once.
+    std::unique_ptr<T const> exchange (std::unique_ptr<T const> snapshot)
+    {
+        return std::unique_ptr<T const> (ptr.exchange (snapshot.release (),
+                std::memory_order_seq_cst));
+    }
+
+private:
+    static void destroy (void const * p)
+    {
+        delete static_cast<T const *>(p);
+    }
+
+    std::atomic<T const *> ptr {nullptr};
+};
+
+
+} // namespace log4cplus::helpers
+
+#endif // LOG4CPLUS_HELPERS_SNAPSHOT_HEADER_
@@ -70,6 +70,9 @@ namespace log4cplus {
 
             void swap (AbstractSocket &);
 
+            /// Returns the underlying socket handle.
+            SOCKET_TYPE getSocketHandle () const { return sock; }
+
         protected:
             SOCKET_TYPE sock;
             SocketState state;
@@ -110,6 +113,13 @@ namespace log4cplus {
                     (&args)... };
                 return socket.write (sizeof... (Args), buffers);
             }
+
+            /**
+             * Connects to a local stream socket (`AF_UNIX`) bound at
+             * `path`. On Linux, path starting with `@` denotes socket
+             * in the abstract namespace.
+             */
+            static Socket connectUnix(const tstring& path);
         };
 
 
@@ -133,7 +143,16 @@ namespace log4cplus {
             void interruptAccept ();
             void swap (ServerSocket &);
 
+            /**
+             * Opens listening local stream socket (`AF_UNIX`) bound at
+             * `path`. Stale socket file left behind at `path` by previous
+             * server instance is removed first.
+             */
+            static ServerSocket listenUnix(const tstring& path);
+
         protected:
+            ServerSocket(SOCKET_TYPE sock, SocketState state, int err);
+
             std::array<std::ptrdiff_t, 2> interruptHandles;
         };
 
@@ -145,6 +164,10 @@ namespace log4cplus {
 
         LOG4CPLUS_EXPORT SOCKET_TYPE connectSocket(const log4cplus::tstring& hostn,
             unsigned short port, bool udp, bool ipv6, SocketState& state);
+        LOG4CPLUS_EXPORT SOCKET_TYPE openUnixSocket(tstring const & path,
+            SocketState& state);
+        LOG4CPLUS_EXPORT SOCKET_TYPE connectUnixSocket(tstring const & path,
+            SocketState& state);
         LOG4CPLUS_EXPORT SOCKET_TYPE acceptSocket(SOCKET_TYPE sock, SocketState& state);
         LOG4CPLUS_EXPORT int closeSocket(SOCKET_TYPE sock);
         LOG4CPLUS_EXPORT int shutdownSocket(SOCKET_TYPE sock);
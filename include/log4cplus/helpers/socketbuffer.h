@@ -43,6 +43,11 @@ class LOG4CPLUS_EXPORT SocketBuffer
 {
 public:
     explicit SocketBuffer(std::size_t max);
+    /**
+     * Wraps `size` bytes of data at `data` for reading. The memory is not
+     * copied and it is not owned by the buffer.
+     */
+    SocketBuffer(char * data, std::size_t size);
     SocketBuffer(SocketBuffer const & rhs) = delete;
     SocketBuffer& operator= (SocketBuffer const& rhs) = delete;
     virtual ~SocketBuffer();
@@ -70,6 +75,7 @@ private:
     std::size_t size;
     std::size_t pos;
     char *buffer;
+    bool owner = true;
 };
 
 } // end namespace helpers
@@ -34,11 +34,27 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 
 
 namespace log4cplus {
     namespace helpers {
 
+        //! Immutable string shared by reference counting.
+        typedef std::shared_ptr<log4cplus::tstring const> SharedTString;
+
+        /**
+         * Returns shared immutable copy of <code>s</code>. Equal strings
+         * interned while a handle returned for either of them is still
+         * alive share one instance.
+         *
+         * This is meant for strings like logger and thread names which
+         * are repeated in many logging events.
+         */
+        LOG4CPLUS_EXPORT SharedTString internString(
+            const log4cplus::tstring_view& s);
+
+
         /**
          * Returns <code>s</code> in upper case.
          */
@@ -32,8 +32,12 @@
 
 #include <log4cplus/logger.h>
 #include <log4cplus/thread/syncprims.h>
-#include <map>
+#include <array>
+#include <functional>
 #include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 
@@ -55,10 +59,20 @@ namespace log4cplus {
      * children. Moreover, loggers can be instantiated in any order, in
      * particular descendant before ancestor.
      *
-     * In case a descendant is created before a particular ancestor,
-     * then it creates a provision node for the ancestor and adds itself
-     * to the provision node. Other descendants of the same ancestor add
-     * themselves to the previously created provision node.
+     * Logger names are additionally kept in a trie keyed on
+     * `.`-separated name segments. In case a descendant is created before
+     * a particular ancestor, the trie node of the ancestor exists without
+     * a logger attached. When the ancestor is created later, its
+     * descendants are found in its subtree of the trie. Both parent
+     * resolution and child fix-up thus only visit the trie nodes of the
+     * name's segments and of the affected subtree. Trie nodes are
+     * allocated from an arena, which is released as a whole when the
+     * trie is dropped.
+     *
+     * Loggers are kept in a hash table split into several shards, each
+     * guarded by its own reader/writer lock. Looking up an existing
+     * logger only takes a shared lock of one shard. Only creation of
+     * a new logger takes the hierarchy's exclusive lock.
      */
     class LOG4CPLUS_EXPORT Hierarchy
     {
@@ -179,7 +193,21 @@ namespace log4cplus {
             spi::LoggerFactory& factory);
 
         /**
-         * Returns all the currently defined loggers in this hierarchy.
+         * Return logger instances for all of <code>names</code>, in the
+         * same order, using the default factory.
+         *
+         * Missing loggers are created as by {@link #getInstance}, but
+         * the hierarchy is locked only once for the whole batch. This is
+         * useful for creating large numbers of loggers at start-up.
+         *
+         * @param names The names of the loggers to retrieve.
+         */
+        virtual LoggerList getInstances(
+            const std::vector<log4cplus::tstring>& names);
+
+        /**
+         * Returns all the currently defined loggers in this hierarchy,
+         * sorted by name.
          *
          * The root logger is <em>not</em> included in the returned list.
          */
@@ -237,9 +265,95 @@ namespace log4cplus {
 
     private:
       // Types
-        typedef std::vector<Logger> ProvisionNode;
-        typedef std::map<log4cplus::tstring, ProvisionNode, std::less<>> ProvisionNodeMap;
-        typedef std::map<log4cplus::tstring, Logger, std::less<>> LoggerMap;
+        //! Logger name together with its hash, computed only once per
+        //! lookup and used both for shard selection and for the lookup
+        //! within the shard.
+        struct HashedName
+        {
+            explicit HashedName (log4cplus::tstring_view const & n)
+                : name (n)
+                , hash (std::hash<log4cplus::tstring_view> () (n))
+            { }
+
+            log4cplus::tstring_view name;
+            std::size_t hash;
+        };
+
+        struct LoggerNameHash
+        {
+            using is_transparent = void;
+
+            std::size_t
+            operator () (log4cplus::tstring_view const & name) const
+                LOG4CPLUS_NOEXCEPT
+            {
+                return std::hash<log4cplus::tstring_view> () (name);
+            }
+
+            std::size_t
+            operator () (HashedName const & hn) const LOG4CPLUS_NOEXCEPT
+            {
+                return hn.hash;
+            }
+        };
+
+        struct LoggerNameEqual
+        {
+            using is_transparent = void;
+
+            bool
+            operator () (log4cplus::tstring_view const & a,
+                log4cplus::tstring_view const & b) const LOG4CPLUS_NOEXCEPT
+            {
+                return a == b;
+            }
+
+            bool
+            operator () (HashedName const & a,
+                log4cplus::tstring_view const & b) const LOG4CPLUS_NOEXCEPT
+            {
+                return a.name == b;
+            }
+
+            bool
+            operator () (log4cplus::tstring_view const & a,
+                HashedName const & b) const LOG4CPLUS_NOEXCEPT
+            {
+                return a == b.name;
+            }
+        };
+
+        typedef std::unordered_map<log4cplus::tstring, Logger, LoggerNameHash,
+            LoggerNameEqual> LoggerMap;
+
+        //! One shard of the logger table. Modifications of `loggers` are
+        //! done with both `hashtable_mutex` and `mtx` held exclusively,
+        //! therefore holding just `hashtable_mutex` is enough for reading.
+        struct LoggerMapShard
+        {
+            mutable std::shared_mutex mtx;
+            LoggerMap loggers;
+        };
+
+        static constexpr std::size_t LOGGER_MAP_SHARDS = 16;
+
+        //! Node of the logger name trie. Each node stands for one
+        //! `.`-separated segment of a logger name. `logger` is null for
+        //! nodes of names which have descendants but which have not been
+        //! instantiated themselves. Loggers are owned by `loggerPtrs`.
+        //! Nodes, including their maps, live in `trieArena` and are never
+        //! destroyed one by one.
+        struct LoggerTrieNode
+        {
+            explicit LoggerTrieNode (std::pmr::memory_resource * arena)
+                : children (arena)
+            { }
+
+            std::pmr::unordered_map<
+                std::pmr::basic_string<log4cplus::tchar>,
+                LoggerTrieNode *, LoggerNameHash, LoggerNameEqual> children;
+            spi::LoggerImpl * logger = nullptr;
+        };
 
       // Methods
         /**
@@ -250,6 +364,20 @@ namespace log4cplus {
         Logger getInstanceImpl(const log4cplus::tstring_view& name,
             spi::LoggerFactory& factory);
 
+        /**
+         * Looks up existing logger in its shard of the logger table under
+         * shared lock of the shard. Returns logger with null `value` if
+         * there is no such logger.
+         */
+        LOG4CPLUS_PRIVATE
+        Logger findLogger(HashedName const & hn) const;
+
+        LOG4CPLUS_PRIVATE
+        LoggerMapShard & getShard(HashedName const & hn);
+
+        LOG4CPLUS_PRIVATE
+        LoggerMapShard const & getShard(HashedName const & hn) const;
+
         /**
          * This is the implementation of the <code>getCurrentLoggers()</code>.
          * NOTE: This method does not lock the <code>hashtable_mutex</code>.
@@ -258,49 +386,39 @@ namespace log4cplus {
         void initializeLoggerList(LoggerList& list) const;
 
         /**
-         * This method loops through all the *potential* parents of
-         * logger'. There 3 possible cases:
-         *
-         * 1) No entry for the potential parent of 'logger' exists
-         *
-         *    We create a ProvisionNode for this potential parent and insert
-         *    'logger' in that provision node.
-         *
-         * 2) There is an entry of type Logger for the potential parent.
-         *
-         *    The entry is 'logger's nearest existing parent. We update logger's
-         *    parent field with this entry. We also break from the loop
-         *    because updating our parent's parent is our parent's
-         *    responsibility.
-         *
-         * 3) There entry is of type ProvisionNode for this potential parent.
-         *
-         *    We add 'logger' to the list of children for this potential parent.
+         * This method walks the trie along the segments of the name of
+         * 'logger', creating missing nodes on the way. The nearest
+         * ancestor node that has a logger attached becomes the parent of
+         * 'logger'; if there is none, the root logger does. The logger is
+         * then attached to the node of its name, which is returned.
          */
-        LOG4CPLUS_PRIVATE void updateParents(Logger const & logger);
+        LOG4CPLUS_PRIVATE LoggerTrieNode & updateParents(
+            Logger const & logger);
 
         /**
-         * We update the links for all the children that placed themselves
-         * in the provision node 'pn'. The second argument 'logger' is a
-         * reference for the newly created Logger, parent of all the
-         * children in 'pn'
-         *
-         * We loop on all the children 'c' in 'pn':
-         *
-         *    If the child 'c' has been already linked to a child of
-         *    'logger' then there is no need to update 'c'.
-         *
-         *   Otherwise, we set logger's parent field to c's parent and set
-         *   c's parent field to logger.
+         * We update the links for all the children of the newly created
+         * 'logger' which were created before it. These are the loggers in
+         * the subtree of 'node' that do not have any other logger between
+         * them and 'node'. Their parent field is set to 'logger' and
+         * their dispatch lists, and thus those of their descendants,
+         * become stale.
          */
-        LOG4CPLUS_PRIVATE void updateChildren(ProvisionNode& pn,
+        LOG4CPLUS_PRIVATE void updateChildren(LoggerTrieNode & node,
             Logger const & logger);
 
+        //! Allocates new trie node in `trieArena`.
+        LOG4CPLUS_PRIVATE LoggerTrieNode * newTrieNode();
+
+        //! Drops the whole trie by releasing `trieArena`, without visiting
+        //! its nodes, and starts a new empty one.
+        LOG4CPLUS_PRIVATE void resetLoggerTrie();
+
      // Data
         thread::Mutex hashtable_mutex;
         std::unique_ptr<spi::LoggerFactory> defaultFactory;
-        ProvisionNodeMap provisionNodes;
-        LoggerMap loggerPtrs;
+        std::pmr::monotonic_buffer_resource trieArena;
+        LoggerTrieNode * loggerTrie;
+        std::array<LoggerMapShard, LOGGER_MAP_SHARDS> loggerPtrs;
         Logger root;
 
         int disableValue;
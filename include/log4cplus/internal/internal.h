@@ -48,7 +48,13 @@
 #endif
 
 #include <memory>
+#include <typeinfo>
 #include <vector>
+#include <deque>
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+#include <mutex>
+#include <condition_variable>
+#endif
 #include <sstream>
 #include <cstdio>
 #include <log4cplus/tstring.h>
@@ -62,6 +68,8 @@
 
 namespace log4cplus {
 
+class Appender;
+
 namespace internal {
 
 
@@ -105,9 +113,51 @@ struct appender_sratch_pad
     tostringstream oss;
     tstring str;
     std::string chstr;
+
+    //! Event formatted by `formatted_by` before it has taken its
+    //! `access_mutex`. Valid only while that appender appends
+    //! `formatted_event`.
+    tstring formatted;
+    Appender const * formatted_by = nullptr;
+    spi::InternalLoggingEvent const * formatted_event = nullptr;
+
+    //! Output of layouts shared by appenders within one dispatch of
+    //! `dispatch_event` by LoggerImpl::callAppenders(). Only the first
+    //! `dispatch_formats_count` entries are valid; the rest are kept to
+    //! reuse their buffers. They are formatted through `dispatch_oss`
+    //! because appenders may be composing their output in `oss` at the
+    //! time.
+    struct shared_format
+    {
+        std::type_info const * layout_type;
+        tstring key;
+        tstring text;
+    };
+
+    spi::InternalLoggingEvent const * dispatch_event = nullptr;
+    std::vector<shared_format> dispatch_formats;
+    std::size_t dispatch_formats_count = 0;
+    tostringstream dispatch_oss;
 };
 
 
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+//! Serial queue of events of one asynchronous appender. At most one task
+//! draining the queue is scheduled on the thread pool at any time, so the
+//! appender never occupies more than one worker and its events are
+//! appended in the order they were logged.
+struct AsyncStrand
+{
+    std::mutex mtx;
+    //! Signalled when the drain task makes room in the queue.
+    std::condition_variable not_full;
+    std::deque<spi::InternalLoggingEvent> events;
+    //! A drain task is queued or running.
+    bool scheduled = false;
+};
+#endif
+
+
 //! Per thread data.
 struct per_thread_data
 {
@@ -117,10 +167,12 @@ struct per_thread_data
     tstring macros_str;
     tostringstream macros_oss;
     tostringstream layout_oss;
-    DiagnosticContextStack ndc_dcs;
+    SharedDiagnosticContextFrame ndc_dcs;
     MappedDiagnosticContext mdc;
     log4cplus::tstring thread_name;
     log4cplus::tstring thread_name2;
+    helpers::SharedTString thread_name_handle;
+    helpers::SharedTString thread_name2_handle;
     gft_scratch_pad gft_sp;
     appender_sratch_pad appender_sp;
     log4cplus::tstring faa_str;
@@ -211,6 +263,12 @@ get_thread_name2_str ()
 }
 
 
+//! Interned copies of thread names, created on first use and dropped
+//! when the names change. Defined in threads.cxx.
+helpers::SharedTString const & get_thread_name_handle ();
+helpers::SharedTString const & get_thread_name2_handle ();
+
+
 inline
 gft_scratch_pad &
 get_gft_scratch_pad ()
@@ -84,8 +84,32 @@ namespace log4cplus {
         virtual void formatAndAppend(log4cplus::tostream& output,
             const log4cplus::spi::InternalLoggingEvent& event) = 0;
 
+        /**
+         * Returns a string describing configuration of this layout.
+         * Layouts of the same type with equal non-empty keys format any
+         * event identically, which allows appenders to share the output
+         * of one of them. Layouts with empty key are never shared.
+         */
+        log4cplus::tstring const & getFormatKey() const { return formatKey; }
+
+        /**
+         * Returns the set of optional event fields, see
+         * spi::EventField, that this layout reads when formatting
+         * events. It is all fields unless a derived layout says
+         * otherwise.
+         */
+        unsigned getEventFields() const { return eventFields; }
+
     protected:
         LogLevelManager& llmCache;
+
+        //! See getFormatKey(). Derived layouts set it when their
+        //! configuration changes.
+        log4cplus::tstring formatKey;
+
+        //! See getEventFields(). Derived layouts set it in their
+        //! constructors.
+        unsigned eventFields;
     };
 
 
@@ -186,6 +210,8 @@ namespace log4cplus {
         void setContextPrinting(bool);
 
     protected:
+        void updateFormatKey();
+
        log4cplus::tstring dateFormat;
        bool use_gmtime = false;
        bool thread_printing = true;
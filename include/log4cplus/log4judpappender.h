@@ -74,6 +74,7 @@ namespace log4cplus {
     protected:
         void openSocket();
         virtual void append(const spi::InternalLoggingEvent& event) override;
+        virtual bool usesFormattedEvent() const override { return true; }
 
       // Data
         log4cplus::helpers::Socket socket;
@@ -33,6 +33,7 @@
 
 #include <log4cplus/loglevel.h>
 #include <log4cplus/tstring.h>
+#include <log4cplus/helpers/stringhelper.h>
 #include <log4cplus/spi/appenderattachable.h>
 #include <log4cplus/spi/loggerfactory.h>
 
@@ -81,7 +82,7 @@ namespace log4cplus
 
         /*
          * Returns all the currently defined loggers in the default
-         * hierarchy.
+         * hierarchy, sorted by name.
          *
          * The root logger is <em>not</em> included in the returned
          * list.
@@ -241,6 +242,19 @@ namespace log4cplus
          */
         log4cplus::tstring const & getName() const;
 
+        /**
+         * Return the interned logger name. Logging events created for
+         * this logger share it.
+         */
+        helpers::SharedTString const & getNameHandle() const;
+
+        /**
+         * Return the set of optional event fields, see
+         * spi::EventField, that appenders of this logger read. Events
+         * created by macros capture only these.
+         */
+        unsigned getEventFields() const;
+
         /**
          * Get the additivity flag for this Logger instance.
          */
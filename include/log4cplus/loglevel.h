@@ -32,10 +32,11 @@
 #pragma once
 #endif
 
+#include <atomic>
 #include <vector>
 #include <memory>
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-#include <shared_mutex>
+#include <mutex>
 #endif
 #include <log4cplus/tstring.h>
 #include <log4cplus/helpers/pointer.h>
@@ -148,8 +149,14 @@ namespace log4cplus {
          * This method is called by all Layout classes to convert a LogLevel
          * into a string.
          *
-         * Note: It traverses the list of <code>LogLevelToStringMethod</code>
-         *       to do this, so all "derived" LogLevels are recognized as well.
+         * Note: Names given by all registered translators are cached
+         *       in a lookup table, so all "derived" LogLevels are
+         *       recognized as well. Once a level has been looked up, the
+         *       lookup neither locks nor calls the translators.
+         *
+         * Note: The returned reference stays valid for the lifetime of
+         *       this LogLevelManager, even if the level is removed
+         *       later.
          */
         log4cplus::tstring const & toString(LogLevel ll) const;
 
@@ -167,14 +174,37 @@ namespace log4cplus {
 
         void pushLogLevelTranslator(SharedLogLevelTranslatorPtr);
 
+        /**
+         * Rebuilds the lookup table used by toString() from the
+         * registered translators. Translators whose mapping changes
+         * after they have been pushed must call this after each change.
+         */
+        void reloadLogLevelTranslators();
+
     private:
+        typedef std::vector<SharedLogLevelTranslatorPtr> LogLevelTranslatorList;
+
+        //! Immutable names of log levels, see loglevel.cxx.
+        struct LookupTable;
+
+        //! Builds new lookup table and publishes it. `mtx` must be held.
+        LOG4CPLUS_PRIVATE void rebuildLookupTable();
+
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-        mutable std::shared_mutex mtx;
+        mutable std::mutex mtx;
 #endif
 
-        typedef std::vector<SharedLogLevelTranslatorPtr> LogLevelTranslatorList;
         LogLevelTranslatorList translator_list;
 
+        //! The current lookup table.
+        std::atomic<LookupTable *> table {nullptr};
+
+        //! All lookup tables built so far. They own the names returned
+        //! by toString() and are kept until destruction, so that these
+        //! stay valid. Tables are filled in lazily, replaced ones are
+        //! small.
+        std::vector<std::unique_ptr<LookupTable>> tables;
+
         // Disable Copy
         LogLevelManager(const LogLevelManager&);
         LogLevelManager& operator=(const LogLevelManager&);
@@ -36,6 +36,7 @@
 #include <map>
 #include <unordered_map>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <deque>
 
@@ -55,6 +56,11 @@ using MappedDiagnosticContextStacksMap
 using MappedDiagnosticContextMap = std::map<tstring, tstring,
     std::less<>>;
 
+//! Immutable snapshot of mapped diagnostic context map. Logging events
+//! capture the context by sharing the current snapshot.
+using SharedMappedDiagnosticContextMap
+    = std::shared_ptr<MappedDiagnosticContextMap const>;
+
 //! Internal MDC storage.
 struct LOG4CPLUS_EXPORT MappedDiagnosticContext final
 {
@@ -69,15 +75,19 @@ struct LOG4CPLUS_EXPORT MappedDiagnosticContext final
 
     void clear ();
 
+    //! Returns current context map for modification. The map is copied
+    //! first if a snapshot of it is shared with logging events.
+    MappedDiagnosticContextMap & getWritableContextMap ();
+
 
     //! Backing map for the mapped diagnostic context.
     //! This allows MDCGuard to push and pop values.
     MappedDiagnosticContextStacksMap stacks_map;
 
-    //! Current mapped diagnostic context map.
+    //! Current mapped diagnostic context map. It is never null.
     //! This map is used for rendering in layouts.
     //! \see MDC::getContext
-    MappedDiagnosticContextMap context_map;
+    std::shared_ptr<MappedDiagnosticContextMap> context_map;
 };
 
 
@@ -122,8 +132,21 @@ public:
     std::optional<tstring> get (tstring_view const & key) const;
     void remove (tstring const & key);
 
+    /**
+     * Returns current context. The reference is only valid until the
+     * next modification of the context by this thread, which may replace
+     * the map if a snapshot of it is held elsewhere. Use
+     * getContextSnapshot() to keep the context for longer.
+     */
     MappedDiagnosticContextMap const & getContext () const;
 
+    /**
+     * Returns current context as a shared immutable snapshot. Taking
+     * the snapshot does not copy the context; the context is copied on
+     * its next modification instead.
+     */
+    SharedMappedDiagnosticContextMap getContextSnapshot () const;
+
     // Public ctor and dtor but only to be used by internal::DefaultContext.
     MDC ();
     virtual ~MDC ();
@@ -36,12 +36,17 @@
 
 #include <map>
 #include <deque>
+#include <memory>
+#include <mutex>
 
 
 namespace log4cplus {
     // Forward declarations
     struct DiagnosticContext;
     typedef std::deque<DiagnosticContext> DiagnosticContextStack;
+    class DiagnosticContextFrame;
+    typedef std::shared_ptr<DiagnosticContextFrame const>
+        SharedDiagnosticContextFrame;
 
     /**
      * The NDC class implements <i>nested diagnostic contexts</i> as
@@ -101,6 +106,11 @@ namespace log4cplus {
      * method. A thread may obtain a copy of its NDC with the {@link
      * #cloneStack cloneStack} method and pass the reference to any other
      * thread, in particular to a child.
+     *
+     * Internally, the context is a chain of immutable frames, each
+     * pointing to the frame pushed before it. {@link #getSnapshot}
+     * and the matching {@link #inherit} overload pass the context
+     * around by sharing the top frame, without copying.
      */
     class LOG4CPLUS_EXPORT NDC
     {
@@ -146,6 +156,20 @@ namespace log4cplus {
          */
         void inherit(const DiagnosticContextStack& stack);
 
+        /**
+         * Returns the top frame of the diagnostic context of the current
+         * thread, or null if the context is empty. Frames are immutable,
+         * so the snapshot is not affected by further changes of the
+         * context and can be handed to another thread.
+         */
+        SharedDiagnosticContextFrame getSnapshot() const;
+
+        /**
+         * Inherit the diagnostic context captured by {@link
+         * #getSnapshot}. This only shares the frames.
+         */
+        void inherit(SharedDiagnosticContextFrame const & snapshot);
+
         /**
          * Used when printing the diagnostic context.
          */
@@ -260,11 +284,7 @@ namespace log4cplus {
 
     private:
       // Methods
-        LOG4CPLUS_PRIVATE static DiagnosticContextStack* getPtr();
-
-        template <typename StringType>
-        LOG4CPLUS_PRIVATE
-        void push_worker (StringType const &);
+        LOG4CPLUS_PRIVATE static SharedDiagnosticContextFrame* getPtr();
 
       // Disallow construction (and copying) except by getNDC()
         NDC(const NDC&);
@@ -279,7 +299,47 @@ namespace log4cplus {
 
 
     /**
-     * This is the internal object that is stored on the NDC stack.
+     * One level of nested diagnostic context. Frames are immutable and
+     * shared by threads and logging events. The full message of the
+     * context is only rendered when it is asked for.
+     */
+    class LOG4CPLUS_EXPORT DiagnosticContextFrame
+    {
+    public:
+        DiagnosticContextFrame(log4cplus::tstring message,
+            SharedDiagnosticContextFrame parent);
+
+        DiagnosticContextFrame(DiagnosticContextFrame const &) = delete;
+        DiagnosticContextFrame & operator = (
+            DiagnosticContextFrame const &) = delete;
+
+        ~DiagnosticContextFrame();
+
+        //! The message at this context level.
+        log4cplus::tstring const & getMessage() const { return message; }
+
+        //! Messages of this and all outer frames separated by space.
+        log4cplus::tstring const & getFullMessage() const;
+
+        //! The frame pushed before this one, or null.
+        SharedDiagnosticContextFrame const & getParent() const
+        { return parent; }
+
+        //! Number of frames up to and including this one.
+        std::size_t getDepth() const { return depth; }
+
+    private:
+        log4cplus::tstring const message;
+        SharedDiagnosticContextFrame const parent;
+        std::size_t const depth;
+        mutable std::once_flag fullMessageFlag;
+        mutable log4cplus::tstring fullMessage;
+    };
+
+
+    /**
+     * This is the object that represents one level of NDC in stacks
+     * returned by `NDC::cloneStack()`.
      */
     struct LOG4CPLUS_EXPORT DiagnosticContext
     {
@@ -59,6 +59,7 @@ namespace log4cplus {
 
     protected:
         virtual void append(const spi::InternalLoggingEvent& event) override;
+        virtual bool usesFormattedEvent() const override { return true; }
         virtual WORD getEventType(const spi::InternalLoggingEvent& event);
         virtual WORD getEventCategory(const spi::InternalLoggingEvent& event);
         void init();
@@ -49,6 +49,7 @@ namespace log4cplus {
 
       // Methods
         virtual void close() override;
+        virtual unsigned getEventFields() const override;
 
     protected:
         virtual void append(const log4cplus::spi::InternalLoggingEvent& event) override;
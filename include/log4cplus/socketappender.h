@@ -32,6 +32,7 @@
 
 #include <log4cplus/appender.h>
 #include <log4cplus/helpers/socket.h>
+#include <log4cplus/helpers/sharedmemoryring.h>
 #include <log4cplus/thread/syncprims.h>
 #include <log4cplus/thread/threads.h>
 #include <log4cplus/helpers/connectorthread.h>
@@ -100,6 +101,25 @@ namespace log4cplus
      * <dd>Boolean value specifying whether to use IPv6 (true) or IPv4
      * (false). Default value is false.</dd>
      *
+     * <dt><tt>UnixSocket</tt></dt>
+     * <dd>Path of local stream (<code>AF_UNIX</code>) socket to send
+     * events to, e.g., a collector running on the same host. When set,
+     * <tt>host</tt>, <tt>port</tt> and <tt>IPv6</tt> are ignored. On
+     * Linux, path starting with <code>@</code> denotes socket in the
+     * abstract namespace.</dd>
+     *
+     * <dt><tt>SharedMemory</tt></dt>
+     * <dd>Boolean value. When true and <tt>UnixSocket</tt> is set, events
+     * are passed to the collector through a ring in memory shared with
+     * it instead of being written into the socket, see
+     * helpers::SharedMemoryRing. The collector has to accept the ring,
+     * e.g., <code>loggingserver shm:<em>path</em></code>. Only
+     * available on Linux. Default value is false.</dd>
+     *
+     * <dt><tt>SharedMemorySize</tt></dt>
+     * <dd>Size of the shared memory ring in bytes. Default value is
+     * 1 MiB.</dd>
+     *
      * </dl>
      */
     class LOG4CPLUS_EXPORT SocketAppender
@@ -127,6 +147,8 @@ namespace log4cplus
     protected:
         void openSocket();
         void initConnector ();
+        helpers::Socket connectToServer () const;
+        helpers::SharedMemoryRing offerSharedMemory (helpers::Socket &) const;
         virtual void append(const spi::InternalLoggingEvent& event) override;
 
       // Data
@@ -135,6 +157,10 @@ namespace log4cplus
         unsigned int port;
         log4cplus::tstring serverName;
         bool ipv6 = false;
+        log4cplus::tstring unixSocket;
+        bool sharedMemory = false;
+        unsigned int sharedMemorySize = 1024 * 1024;
+        log4cplus::helpers::SharedMemoryRing ring;
 
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
         virtual thread::Mutex const & ctcGetAccessMutex () const override;
@@ -143,6 +169,8 @@ namespace log4cplus
         virtual void ctcSetConnected () override;
 
         volatile bool connected;
+        //! Ring offered by ctcConnect(), waiting for ctcSetConnected().
+        helpers::SharedMemoryRing pendingRing;
         helpers::SharedObjectPtr<helpers::ConnectorThread> connector;
 #endif
     };
@@ -31,7 +31,10 @@
 #pragma once
 #endif
 
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include <log4cplus/helpers/pointer.h>
 #include <log4cplus/loglevel.h>
@@ -74,6 +77,14 @@ namespace log4cplus {
         LOG4CPLUS_EXPORT FilterResult checkFilter(const Filter* filter,
                                                   const InternalLoggingEvent& event);
 
+        /**
+         * Returns union of optional event fields, see EventField, read by
+         * filters of the chain starting at <code>filter</code>.
+         *
+         * Note: <code>filter</code> can be NULL.
+         */
+        LOG4CPLUS_EXPORT unsigned getFilterEventFields(const Filter* filter);
+
         typedef helpers::SharedObjectPtr<Filter> FilterPtr;
 
 
@@ -130,6 +141,22 @@ namespace log4cplus {
              */
             virtual FilterResult decide(const InternalLoggingEvent& event) const = 0;
 
+            /**
+             * Returns the set of optional event fields, see EventField,
+             * that {@link #decide} reads. Default is all fields.
+             */
+            virtual unsigned getEventFields() const;
+
+            /**
+             * Returns true if {@link #decide} reads only the log level of
+             * the event. In that case levels at which the decision can
+             * change are appended to <code>breakpoints</code>, the
+             * decision is the same for all levels between two adjacent
+             * breakpoints. Default is false.
+             */
+            virtual bool getLevelBreakpoints(
+                std::vector<LogLevel>& breakpoints) const;
+
           // Data
             /**
              * Points to the next filter in the filter chain.
@@ -138,6 +165,62 @@ namespace log4cplus {
         };
 
 
+        /**
+         * Filter chain compiled for evaluation. Runs of filters which
+         * decide by log level alone, see Filter::getLevelBreakpoints(),
+         * are collapsed into tables indexed by log level. Only the
+         * other filters are called. If the chain starts with such
+         * filters and they decide the event, or if there are no other
+         * filters, the event is decided by a single table lookup.
+         *
+         * Changes of the chain made after compilation are not seen.
+         */
+        class LOG4CPLUS_EXPORT CompiledFilterChain
+        {
+        public:
+            CompiledFilterChain();
+            explicit CompiledFilterChain(FilterPtr head);
+            ~CompiledFilterChain();
+
+            /**
+             * Returns the same decision as <code>checkFilter()</code>
+             * for the compiled chain.
+             */
+            FilterResult check(const InternalLoggingEvent& event) const;
+
+            //! The first filter of the compiled chain.
+            FilterPtr const & getHead() const { return head; }
+
+        private:
+          // Types
+            //! Decision for each range of log levels starting at
+            //! <code>from[i]</code>.
+            struct LevelTable
+            {
+                std::vector<LogLevel> from;
+                std::vector<FilterResult> result;
+
+                FilterResult lookup(LogLevel ll) const;
+            };
+
+            //! Either a level table or a filter to call.
+            struct Step
+            {
+                LevelTable levels;
+                Filter const * filter;
+            };
+
+          // Methods
+            LOG4CPLUS_PRIVATE static LevelTable compileLevels(
+                std::vector<Filter const *> const & filters);
+
+          // Data
+            FilterPtr head;
+            LevelTable leading;
+            std::vector<Step> steps;
+        };
+
+
 
         /**
          * This filter drops all logging events.
@@ -157,6 +240,9 @@ namespace log4cplus {
              * {@link InternalLoggingEvent} parameter.
              */
             virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
+            virtual bool getLevelBreakpoints(
+                std::vector<LogLevel>& breakpoints) const override;
         };
 
 
@@ -187,6 +273,9 @@ namespace log4cplus {
              * property is set to <code>false</code>.
              */
             virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
+            virtual bool getLevelBreakpoints(
+                std::vector<LogLevel>& breakpoints) const override;
 
         private:
           // Methods
@@ -235,6 +324,9 @@ namespace log4cplus {
              * Return the decision of this filter.
              */
             virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
+            virtual bool getLevelBreakpoints(
+                std::vector<LogLevel>& breakpoints) const override;
 
         private:
           // Methods
@@ -270,6 +362,7 @@ namespace log4cplus {
              * Returns {@link #NEUTRAL} is there is no string match.
              */
             virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
 
         private:
           // Methods
@@ -281,6 +374,160 @@ namespace log4cplus {
             log4cplus::tstring stringToMatch;
         };
 
+
+        /**
+         * This filter matches the message of logging event against a set
+         * of strings. The strings are compiled into an Aho-Corasick
+         * automaton, so the cost of matching depends on the length of the
+         * message but not on the number of the strings.
+         *
+         * The filter admits options <b>StringToMatch.1</b>,
+         * <b>StringToMatch.2</b>, etc., <b>PatternFile</b>, which names
+         * a file with one string to match per line, and
+         * <b>AcceptOnMatch</b>. If any of the strings occurs in the
+         * message then the {@link #decide} method returns {@link #ACCEPT}
+         * if the <b>AcceptOnMatch</b> option value is true, if it is false
+         * then {@link #DENY} is returned. Otherwise {@link #NEUTRAL} is
+         * returned. Empty strings are ignored.
+         */
+        class LOG4CPLUS_EXPORT MultiStringMatchFilter : public Filter {
+        public:
+          // ctors
+            MultiStringMatchFilter();
+            MultiStringMatchFilter(const log4cplus::helpers::Properties& p);
+            MultiStringMatchFilter(
+                const std::vector<log4cplus::tstring>& stringsToMatch,
+                bool acceptOnMatch = true);
+            virtual ~MultiStringMatchFilter();
+
+            /**
+             * Returns {@link #NEUTRAL} is there is no string match.
+             */
+            virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
+
+            /**
+             * Returns true if any of the strings to match occurs in
+             * <code>text</code>.
+             */
+            bool matches(const log4cplus::tstring_view& text) const;
+
+        private:
+          // Types
+            //! Compiled automaton, see filter.cxx.
+            struct Automaton;
+
+          // Methods
+            LOG4CPLUS_PRIVATE void compile(
+                const std::vector<log4cplus::tstring>& stringsToMatch);
+
+          // Data
+            /** Do we return ACCEPT when a match occurs. Default is <code>true</code>. */
+            bool acceptOnMatch;
+            std::unique_ptr<Automaton const> automaton;
+        };
+
+        /**
+         * Selects what events share one rate limit or one sampling
+         * counter in RateLimitFilter and SamplingFilter.
+         */
+        enum class FilterKey { LOGGER, /**< Events of the same logger. */
+                               CALL_SITE, /**< Events logged from the same
+                                           *  file and line. */
+                               MESSAGE /**< Events with the same message
+                                        *  once decimal digits are ignored,
+                                        *  which approximates the message
+                                        *  template. */
+                             };
+
+
+        /**
+         * This filter limits the rate of logging events using a token
+         * bucket. Each key, see FilterKey, gets <b>Rate</b> tokens per
+         * <b>Period</b> and can accumulate up to <b>Burst</b> tokens.
+         * An event which finds a token returns {@link #NEUTRAL}, other
+         * events return {@link #DENY}.
+         *
+         * The filter admits options <b>Rate</b>, <b>Period</b> in
+         * seconds (default 1), <b>Burst</b> (default is equal to
+         * <b>Rate</b>), <b>Key</b> with values <code>Logger</code>
+         * (default), <code>CallSite</code> or <code>Message</code>,
+         * <b>Buckets</b>, the number of independent token buckets the
+         * keys are hashed into (default 1024), and
+         * <b>SummaryInterval</b>, the least number of seconds between
+         * two reports of the count of suppressed events through LogLog
+         * (default 10). If <b>Rate</b> is 0, which is the default, all
+         * events return {@link #NEUTRAL}.
+         *
+         * The {@link #decide} method does not lock, the state of each
+         * bucket is a single atomic variable.
+         */
+        class LOG4CPLUS_EXPORT RateLimitFilter : public Filter {
+        public:
+          // ctors
+            RateLimitFilter();
+            RateLimitFilter(const log4cplus::helpers::Properties& p);
+            RateLimitFilter(unsigned rate, unsigned burst,
+                FilterKey key = FilterKey::LOGGER,
+                std::chrono::steady_clock::duration period
+                    = std::chrono::seconds (1));
+            virtual ~RateLimitFilter();
+
+            /**
+             * Returns {@link #DENY} if the event exceeds the rate limit,
+             * {@link #NEUTRAL} otherwise.
+             */
+            virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
+
+        private:
+          // Types
+            //! Token buckets and suppression counter, see filter.cxx.
+            struct State;
+
+          // Data
+            FilterKey key;
+            std::unique_ptr<State> state;
+        };
+
+
+        /**
+         * This filter passes one of every <b>SampleEvery</b> logging
+         * events of each key, see FilterKey. Passed events return
+         * {@link #NEUTRAL}, other events return {@link #DENY}.
+         *
+         * The filter admits options <b>SampleEvery</b> (default 1, which
+         * passes all events), <b>Key</b>, <b>Buckets</b> and
+         * <b>SummaryInterval</b>, see RateLimitFilter.
+         *
+         * The {@link #decide} method does not lock.
+         */
+        class LOG4CPLUS_EXPORT SamplingFilter : public Filter {
+        public:
+          // ctors
+            SamplingFilter();
+            SamplingFilter(const log4cplus::helpers::Properties& p);
+            SamplingFilter(unsigned sampleEvery,
+                FilterKey key = FilterKey::LOGGER);
+            virtual ~SamplingFilter();
+
+            /**
+             * Returns {@link #DENY} for events which are not sampled,
+             * {@link #NEUTRAL} otherwise.
+             */
+            virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+            virtual unsigned getEventFields() const override;
+
+        private:
+          // Types
+            //! Sampling counters and suppression counter, see filter.cxx.
+            struct State;
+
+          // Data
+            FilterKey key;
+            std::unique_ptr<State> state;
+        };
+
         /**
          * This filter allows using `std::function<FilterResult(const
          * InternalLoggingEvent &)>`.
@@ -336,6 +583,7 @@ namespace log4cplus {
                  * Returns {@link #NEUTRAL} is there is no string match.
                  */
                 virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+                virtual unsigned getEventFields() const override;
 
             private:
               // Methods
@@ -382,6 +630,7 @@ namespace log4cplus {
                  * Returns {@link #NEUTRAL} is there is no string match.
                  */
                 virtual FilterResult decide(const InternalLoggingEvent& event) const override;
+                virtual unsigned getEventFields() const override;
 
             private:
               // Methods
@@ -33,7 +33,11 @@
 #include <log4cplus/tstring.h>
 #include <log4cplus/helpers/appenderattachableimpl.h>
 #include <log4cplus/helpers/pointer.h>
+#include <log4cplus/helpers/snapshot.h>
+#include <log4cplus/helpers/stringhelper.h>
 #include <log4cplus/spi/loggerfactory.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -66,6 +70,11 @@ namespace log4cplus {
              * hierarchy circumventing any evaluation of whether to log or not
              * to log the particular log request.
              *
+             * The appenders are taken from a flattened list that is cached
+             * in this logger and rebuilt after appenders, additivity or the
+             * hierarchy have changed. An appender attached to more than one
+             * logger on the path to the root is called only once.
+             *
              * @param event The event to log.
              */
             virtual void callAppenders(const InternalLoggingEvent& event);
@@ -108,12 +117,14 @@ namespace log4cplus {
              *
              * @return LogLevel - the assigned LogLevel.
              */
-            LogLevel getLogLevel() const { return this->ll; }
+            LogLevel getLogLevel() const
+            { return this->ll.load (std::memory_order_relaxed); }
 
             /**
              * Set the LogLevel of this Logger.
              */
-            void setLogLevel(LogLevel _ll) { this->ll = _ll; }
+            void setLogLevel(LogLevel _ll)
+            { this->ll.store (_ll, std::memory_order_relaxed); }
 
             /**
              * Return the {@link Hierarchy} where this <code>Logger</code>
@@ -124,7 +135,13 @@ namespace log4cplus {
             /**
              * Return the logger name.
              */
-            log4cplus::tstring const & getName() const { return name; }
+            log4cplus::tstring const & getName() const { return *name; }
+
+            /**
+             * Return the interned logger name.
+             */
+            helpers::SharedTString const & getNameHandle() const
+            { return name; }
 
             /**
              * Get the additivity flag for this Logger instance.
@@ -136,6 +153,20 @@ namespace log4cplus {
              */
             void setAdditivity(bool additive);
 
+            /**
+             * Returns the set of optional event fields, see EventField,
+             * which appenders that events of this logger are dispatched
+             * to read.
+             */
+            unsigned getEventFields();
+
+            // AppenderAttachable overrides; these invalidate dispatch lists
+            // of this logger and of its descendants.
+            void addAppender(SharedAppenderPtr newAppender) override;
+            void removeAllAppenders() override;
+            void removeAppender(SharedAppenderPtr appender) override;
+            using helpers::AppenderAttachableImpl::removeAppender;
+
             virtual ~LoggerImpl();
 
         protected:
@@ -174,12 +205,13 @@ namespace log4cplus {
 
           // Data
             /** The name of this logger */
-            log4cplus::tstring name;
+            helpers::SharedTString name;
 
             /**
-             * The assigned LogLevel of this logger.
+             * The assigned LogLevel of this logger. It is read by logging
+             * threads without any lock.
              */
-            LogLevel ll;
+            std::atomic<LogLevel> ll;
 
             /**
              * The parent of this logger. All loggers have at least one
@@ -199,10 +231,62 @@ namespace log4cplus {
             bool additive;
 
         private:
+          // Types
+            //! Deduplicated appenders of this logger and of its ancestors,
+            //! up to the first non-additive one, as of `generation`.
+            struct DispatchList
+            {
+                //! getDispatchGeneration() when the list was built.
+                std::uint64_t generation;
+                //! Appender::getEventFieldsEpoch() as of `eventFields`.
+                std::uint64_t fieldsEpoch;
+                ListType appenders;
+                //! Union of Appender::getEventFields() of `appenders`.
+                unsigned eventFields;
+            };
+
+          // Methods
+            /**
+             * Returns the dispatch list of this logger, rebuilding it first
+             * if the hierarchy has changed since it was built. The caller
+             * has to hold helpers::EpochGuard while it uses the list.
+             */
+            LOG4CPLUS_PRIVATE
+            DispatchList const * getDispatchList();
+
+            /**
+             * Returns sum of `dispatchGeneration` of this logger and of
+             * all its ancestors. Changes of any of them are thus seen by
+             * this logger without visiting descendants when they change.
+             * Generations only grow and a logger that gets a new parent
+             * is invalidated itself, so a sum never repeats for a
+             * different hierarchy.
+             */
+            LOG4CPLUS_PRIVATE
+            std::uint64_t getDispatchGeneration() const;
+
+            /**
+             * Marks dispatch lists of this logger and of its descendants
+             * stale. It has to be called after any change of appenders,
+             * additivity or parent of this logger. If `dropCached` is
+             * true, the list cached by this logger is released right
+             * away so that it does not keep removed appenders alive.
+             * Lists of descendants release them when they are rebuilt.
+             */
+            LOG4CPLUS_PRIVATE
+            void invalidateDispatchList(bool dropCached);
+
           // Data
             /** Loggers need to know what Hierarchy they are in. */
             Hierarchy& hierarchy;
 
+            /** Cached dispatch list. Null until first use. */
+            helpers::AtomicSnapshot<DispatchList> dispatchList;
+
+            //! Bumped by invalidateDispatchList(). Dispatch list built for
+            //! an older generation is rebuilt on its next use.
+            std::atomic<std::uint64_t> dispatchGeneration {0};
+
           // Friends
             friend class log4cplus::Logger;
             friend class log4cplus::DefaultLoggerFactory;
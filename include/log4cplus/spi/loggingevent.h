@@ -36,10 +36,32 @@
 #include <log4cplus/mdc.h>
 #include <log4cplus/tstring.h>
 #include <log4cplus/helpers/timehelper.h>
+#include <log4cplus/helpers/stringhelper.h>
 #include <log4cplus/thread/threads.h>
 
 namespace log4cplus {
     namespace spi {
+        /**
+         * Optional fields of logging events. Layouts, filters and
+         * appenders declare sets of these that they read, so that events
+         * capture and copy only fields which some consumer needs. Logger
+         * name, log level and message are always present.
+         */
+        enum EventField : unsigned
+        {
+            EVENT_FIELDS_NONE     = 0,
+            //! Time stamp.
+            EVENT_FIELD_TIMESTAMP = 1u << 0,
+            //! File, line and function.
+            EVENT_FIELD_LOCATION  = 1u << 1,
+            EVENT_FIELD_NDC       = 1u << 2,
+            EVENT_FIELD_MDC       = 1u << 3,
+            EVENT_FIELD_THREAD    = 1u << 4,
+            EVENT_FIELD_THREAD2   = 1u << 5,
+            EVENT_FIELDS_ALL      = (1u << 6) - 1
+        };
+
+
         /**
          * The internal representation of logging events. When an affirmative
          * decision is made to log then a <code>InternalLoggingEvent</code>
@@ -67,6 +89,14 @@ namespace log4cplus {
                 LogLevel loglevel, const log4cplus::tstring_view& message,
                 const char* filename, int line, const char * function = nullptr);
 
+            /**
+             * Same as above but the logger name is given as an interned
+             * handle, e.g., from Logger::getNameHandle().
+             */
+            InternalLoggingEvent(const helpers::SharedTString& logger,
+                LogLevel loglevel, const log4cplus::tstring_view& message,
+                const char* filename, int line, const char * function = nullptr);
+
             InternalLoggingEvent(const log4cplus::tstring_view& logger,
                 LogLevel loglevel, const log4cplus::tstring_view& ndc,
                 MappedDiagnosticContextMap const & mdc,
@@ -83,6 +113,15 @@ namespace log4cplus {
             InternalLoggingEvent(
                 const log4cplus::spi::InternalLoggingEvent& rhs);
 
+            /**
+             * Copies only the optional fields of <code>rhs</code> that are
+             * in the <code>fields</code> set, see EventField. The other
+             * optional fields of the copy are empty.
+             */
+            InternalLoggingEvent(
+                const log4cplus::spi::InternalLoggingEvent& rhs,
+                unsigned fields);
+
             virtual ~InternalLoggingEvent();
 
             void setLoggingEvent (const log4cplus::tstring_view & logger,
@@ -90,6 +129,17 @@ namespace log4cplus {
                 const char * filename, int line,
                 const char * function = nullptr);
 
+            /**
+             * Same as above but the logger name is given as an interned
+             * handle. Time stamp and location are only captured if they
+             * are in the <code>fields</code> set, see EventField.
+             */
+            void setLoggingEvent (const helpers::SharedTString & logger,
+                LogLevel ll, const log4cplus::tstring_view & message,
+                const char * filename, int line,
+                const char * function = nullptr,
+                unsigned fields = EVENT_FIELDS_ALL);
+
             void setFunction (char const * func);
             void setFunction (log4cplus::tstring_view const &);
 
@@ -115,6 +165,13 @@ namespace log4cplus {
              *  the LoggingEvent constructor.
              */
             const log4cplus::tstring& getLoggerName() const
+            {
+                return *loggerName;
+            }
+
+            //! Interned logger name, shared with the logger and with
+            //! copies of this event.
+            helpers::SharedTString const & getLoggerNameHandle() const
             {
                 return loggerName;
             }
@@ -126,21 +183,32 @@ namespace log4cplus {
             }
 
             /** The nested diagnostic context (NDC) of logging event. */
-            const log4cplus::tstring& getNDC() const
+            const log4cplus::tstring& getNDC() const;
+
+            /** The nested diagnostic context (NDC) of logging event as
+             *  its shared top frame, null if the context is empty. */
+            SharedDiagnosticContextFrame const & getNDCSnapshot () const
             {
                 if (!ndcCached)
                 {
-                    ndc = log4cplus::getNDC().get();
+                    ndc = log4cplus::getNDC().getSnapshot();
                     ndcCached = true;
                 }
                 return ndc;
             }
 
             MappedDiagnosticContextMap const & getMDCCopy () const
+            {
+                return *getMDCSnapshot ();
+            }
+
+            /** The mapped diagnostic context (MDC) of logging event. This
+             *  shares the snapshot of the context, it does not copy it. */
+            SharedMappedDiagnosticContextMap const & getMDCSnapshot () const
             {
                 if (!mdcCached)
                 {
-                    mdc = log4cplus::getMDC().getContext ();
+                    mdc = log4cplus::getMDC().getContextSnapshot ();
                     mdcCached = true;
                 }
                 return mdc;
@@ -151,26 +219,24 @@ namespace log4cplus {
             /** The name of thread in which this logging event was generated. */
             const log4cplus::tstring& getThread() const
             {
-                if (! threadCached)
-                {
-                    thread = thread::getCurrentThreadName ();
-                    threadCached = true;
-                }
-                return thread;
+                return *getThreadHandle ();
             }
 
             //! The alternative name of thread in which this logging event
             //! was generated.
             const log4cplus::tstring& getThread2() const
             {
-                if (! thread2Cached)
-                {
-                    thread2 = thread::getCurrentThreadName2 ();
-                    thread2Cached = true;
-                }
-                return thread2;
+                return *getThread2Handle ();
             }
 
+            //! Interned name of thread in which this logging event was
+            //! generated.
+            helpers::SharedTString const & getThreadHandle() const;
+
+            //! Interned alternative name of thread in which this logging
+            //! event was generated.
+            helpers::SharedTString const & getThread2Handle() const;
+
 
             /** Time stamp when the event was created. */
             const log4cplus::helpers::Time& getTimestamp() const
@@ -192,7 +258,12 @@ namespace log4cplus {
                 return function;
             }
 
-            void gatherThreadSpecificData () const;
+            /**
+             * Captures thread specific fields of this event, NDC, MDC and
+             * thread names, which are in the <code>fields</code> set.
+             */
+            void gatherThreadSpecificData (
+                unsigned fields = EVENT_FIELDS_ALL) const;
 
             void swap (InternalLoggingEvent &);
 
@@ -206,12 +277,12 @@ namespace log4cplus {
         protected:
           // Data
             log4cplus::tstring message;
-            log4cplus::tstring loggerName;
+            helpers::SharedTString loggerName;
             LogLevel ll;
-            mutable log4cplus::tstring ndc;
-            mutable MappedDiagnosticContextMap mdc;
-            mutable log4cplus::tstring thread;
-            mutable log4cplus::tstring thread2;
+            mutable SharedDiagnosticContextFrame ndc;
+            mutable SharedMappedDiagnosticContextMap mdc;
+            mutable helpers::SharedTString thread;
+            mutable helpers::SharedTString thread2;
             log4cplus::helpers::Time timestamp;
             log4cplus::tstring file;
             log4cplus::tstring function;
@@ -112,10 +112,12 @@ namespace log4cplus
 
       // Methods
         virtual void close() override;
+        virtual unsigned getEventFields() const override;
 
     protected:
         virtual int getSysLogLevel(const LogLevel& ll) const;
         virtual void append(const spi::InternalLoggingEvent& event) override;
+        virtual bool usesFormattedEvent() const override { return true; }
 #if defined (LOG4CPLUS_HAVE_SYSLOG_H)
         //! Local syslog (served by `syslog()`) worker function.
         void appendLocal(const spi::InternalLoggingEvent& event);
@@ -185,6 +185,29 @@ Semaphore::lock () const
 }
 
 
+LOG4CPLUS_INLINE_EXPORT
+bool
+Semaphore::timed_lock (unsigned long LOG4CPLUS_THREADED (msec)) const
+{
+#if defined (LOG4CPLUS_SINGLE_THREADED)
+    return true;
+
+#else
+    std::unique_lock<std::mutex> guard (mtx);
+
+    if (val > max_) [[unlikely]]
+        LOG4CPLUS_THROW_RTE ("Semaphore::timed_lock(): val > max");
+
+    if (! cv.wait_for (guard, std::chrono::milliseconds (msec),
+            [this] { return val != 0; }))
+        return false;
+
+    --val;
+    return true;
+#endif
+}
+
+
 //
 //
 //
@@ -109,6 +109,9 @@ public:
 
     void lock () const;
     void unlock () const;
+    //! Same as lock() but gives up after `msec` milliseconds.
+    //! \return True if the semaphore has been locked.
+    bool timed_lock (unsigned long msec) const;
 
 private:
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
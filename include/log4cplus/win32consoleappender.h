@@ -77,6 +77,7 @@ namespace log4cplus
 
     protected:
         virtual void append (spi::InternalLoggingEvent const &) override;
+        virtual bool usesFormattedEvent() const override { return true; }
 
         void write_handle (void *, tchar const *, std::size_t);
         void write_console (void *, tchar const *, std::size_t);
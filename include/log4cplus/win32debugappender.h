@@ -56,6 +56,7 @@ namespace log4cplus {
 
     protected:
         virtual void append(const log4cplus::spi::InternalLoggingEvent& event) override;
+        virtual bool usesFormattedEvent() const override { return true; }
 
     private:
       // Disallow copying of instances of this class
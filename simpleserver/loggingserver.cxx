@@ -21,9 +21,13 @@
 #include <cstdlib>
 #include <list>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <log4cplus/configurator.h>
 #include <log4cplus/socketappender.h>
 #include <log4cplus/helpers/socket.h>
+#include <log4cplus/helpers/sharedmemoryring.h>
 #include <log4cplus/thread/threads.h>
 #include <log4cplus/spi/loggingevent.h>
 #include <log4cplus/thread/syncprims.h>
@@ -163,10 +167,12 @@ class ClientThread
     : public log4cplus::thread::AbstractThread
 {
 public:
-    ClientThread(log4cplus::helpers::Socket clientsock_, Reaper & reaper_)
+    ClientThread(log4cplus::helpers::Socket clientsock_, Reaper & reaper_,
+        bool sharedMemory_)
         : self_reference (log4cplus::thread::AbstractThreadPtr (this))
         , clientsock(std::move (clientsock_))
         , reaper (reaper_)
+        , sharedMemory (sharedMemory_)
     {
         std::cout << "Received a client connection!!!!" << std::endl;
     }
@@ -179,38 +185,81 @@ public:
     virtual void run() override;
 
 private:
+    void readSocket ();
+    void readSharedMemory ();
+
     log4cplus::thread::AbstractThreadPtr self_reference;
     log4cplus::helpers::Socket clientsock;
     Reaper & reaper;
+    bool sharedMemory;
 };
 
 
 void
-loggingserver::ClientThread::run()
+dispatch (log4cplus::helpers::SocketBuffer & buffer)
 {
-    try
+    log4cplus::spi::InternalLoggingEvent event
+        = log4cplus::helpers::readFromBuffer(buffer);
+    log4cplus::Logger logger
+        = log4cplus::Logger::getInstance(event.getLoggerName());
+    logger.callAppenders(event);
+}
+
+
+void
+loggingserver::ClientThread::readSocket()
+{
+    while (true)
     {
-        while (true)
-        {
-            if (!clientsock.isOpen())
-                break;
+        if (!clientsock.isOpen())
+            break;
 
-            log4cplus::helpers::SocketBuffer msgSizeBuffer(sizeof(unsigned int));
-            if (!clientsock.read(msgSizeBuffer))
-                break;
+        log4cplus::helpers::SocketBuffer msgSizeBuffer(sizeof(unsigned int));
+        if (!clientsock.read(msgSizeBuffer))
+            break;
 
-            unsigned int msgSize = msgSizeBuffer.readInt();
+        unsigned int msgSize = msgSizeBuffer.readInt();
 
-            log4cplus::helpers::SocketBuffer buffer(msgSize);
-            if (!clientsock.read(buffer))
-                break;
+        log4cplus::helpers::SocketBuffer buffer(msgSize);
+        if (!clientsock.read(buffer))
+            break;
 
-            log4cplus::spi::InternalLoggingEvent event
-                = log4cplus::helpers::readFromBuffer(buffer);
-            log4cplus::Logger logger
-                = log4cplus::Logger::getInstance(event.getLoggerName());
-            logger.callAppenders(event);
-        }
+        dispatch (buffer);
+    }
+}
+
+
+void
+loggingserver::ClientThread::readSharedMemory()
+{
+    log4cplus::helpers::SharedMemoryRing ring
+        = log4cplus::helpers::SharedMemoryRing::accept (clientsock);
+    if (! ring.isOpen ())
+    {
+        std::cerr << "Client did not offer shared memory." << std::endl;
+        return;
+    }
+
+    char * data;
+    std::size_t size;
+    while (ring.read (data, size))
+    {
+        // Events are decoded in place, straight from the shared memory.
+        log4cplus::helpers::SocketBuffer buffer (data, size);
+        dispatch (buffer);
+    }
+}
+
+
+void
+loggingserver::ClientThread::run()
+{
+    try
+    {
+        if (sharedMemory)
+            readSharedMemory ();
+        else
+            readSocket ();
     }
     catch (...)
     {
@@ -231,25 +280,59 @@ main(int argc, char** argv)
 {
     log4cplus::Initializer initializer;
 
-    if(argc < 4) {
+    std::string_view const unix_prefix {"unix:"};
+    std::string_view const shm_prefix {"shm:"};
+    bool const use_shared_memory = argc >= 3
+        && std::string_view (argv[1]).starts_with (shm_prefix);
+    bool const use_unix_socket = use_shared_memory || (argc >= 3
+        && std::string_view (argv[1]).starts_with (unix_prefix));
+
+    if(argc < 4 && ! use_unix_socket) {
         std::cout << "Usage: host port config_file [<IP version>]\n"
+            << "       unix:<socket path> config_file\n"
+            << "       shm:<socket path> config_file\n"
             << "<IP version> either 0 for IPv4 (default) or 1 for IPv6\n"
+            << "shm: expects clients to pass events through shared memory,"
+            " see SocketAppender's SharedMemory property\n"
             << std::flush;
         return 1;
     }
-    int const port = std::atoi(argv[2]);
-    bool const ipv6 = argc >= 5 ? !!std::atoi(argv[4]) : false;
-    const log4cplus::tstring configFile = LOG4CPLUS_C_STR_TO_TSTRING(argv[3]);
-
-    log4cplus::PropertyConfigurator config(configFile);
-    config.configure();
-
-    log4cplus::helpers::ServerSocket serverSocket(port, false, ipv6,
-        LOG4CPLUS_C_STR_TO_TSTRING(argv[1]));
-    if (!serverSocket.isOpen()) {
-        std::cerr << "Could not open server socket, maybe port "
-            << port << " is already in use." << std::endl;
-        return 2;
+
+    std::optional<log4cplus::helpers::ServerSocket> serverSocket;
+    if (use_unix_socket)
+    {
+        std::string const path {
+            std::string_view (argv[1]).substr (use_shared_memory
+                ? shm_prefix.size () : unix_prefix.size ())};
+        const log4cplus::tstring configFile = LOG4CPLUS_C_STR_TO_TSTRING(argv[2]);
+
+        log4cplus::PropertyConfigurator config(configFile);
+        config.configure();
+
+        serverSocket.emplace (log4cplus::helpers::ServerSocket::listenUnix (
+            LOG4CPLUS_STRING_TO_TSTRING (path)));
+        if (!serverSocket->isOpen()) {
+            std::cerr << "Could not open server socket at "
+                << path << "." << std::endl;
+            return 2;
+        }
+    }
+    else
+    {
+        int const port = std::atoi(argv[2]);
+        bool const ipv6 = argc >= 5 ? !!std::atoi(argv[4]) : false;
+        const log4cplus::tstring configFile = LOG4CPLUS_C_STR_TO_TSTRING(argv[3]);
+
+        log4cplus::PropertyConfigurator config(configFile);
+        config.configure();
+
+        serverSocket.emplace (port, false, ipv6,
+            LOG4CPLUS_C_STR_TO_TSTRING(argv[1]));
+        if (!serverSocket->isOpen()) {
+            std::cerr << "Could not open server socket, maybe port "
+                << port << " is already in use." << std::endl;
+            return 2;
+        }
     }
 
     loggingserver::Reaper reaper;
@@ -257,7 +340,8 @@ main(int argc, char** argv)
     for (;;)
     {
         loggingserver::ClientThread *thr =
-            new loggingserver::ClientThread(serverSocket.accept(), reaper);
+            new loggingserver::ClientThread(serverSocket->accept(), reaper,
+                use_shared_memory);
         thr->start();
     }
 
@@ -28,9 +28,19 @@
 #include <log4cplus/spi/loggingevent.h>
 #include <log4cplus/internal/internal.h>
 #include <log4cplus/thread/syncprims-pub-impl.h>
+#include <log4cplus/helpers/eventcounter.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <catch_amalgamated.hpp>
+#endif
 
 
 namespace log4cplus
@@ -90,11 +100,14 @@ Appender::Appender()
    errorHandler(new OnlyOnceErrorHandler),
    useLockFile(false),
    async(false),
+   concurrentFormatting(false),
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
    in_flight(0),
+   strand(new internal::AsyncStrand),
 #endif
    closed(false)
 {
+    updateEventFields ();
 }
 
 
@@ -105,8 +118,10 @@ Appender::Appender(const log4cplus::helpers::Properties & properties)
     , errorHandler(new OnlyOnceErrorHandler)
     , useLockFile(false)
     , async(false)
+    , concurrentFormatting(false)
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
     , in_flight(0)
+    , strand(new internal::AsyncStrand)
 #endif
     , closed(false)
 {
@@ -185,6 +200,8 @@ Appender::Appender(const log4cplus::helpers::Properties & properties)
         addFilter (std::move (tmpFilter));
     }
 
+    updateEventFields ();
+
     // Deal with file locking settings.
     properties.getBool (useLockFile, LOG4CPLUS_TEXT("UseLockFile"));
     if (useLockFile)
@@ -212,6 +229,55 @@ Appender::Appender(const log4cplus::helpers::Properties & properties)
 
     // Deal with asynchronous append flag.
     properties.getBool (async, LOG4CPLUS_TEXT("AsyncAppend"));
+
+    tstring const overflowPolicy = helpers::toLower (
+        properties.getProperty (LOG4CPLUS_TEXT ("OverflowPolicy")));
+    if (! overflowPolicy.empty ())
+    {
+        static struct
+        {
+            tchar const * name;
+            AsyncOverflowPolicy policy;
+        } const policies[] = {
+            {LOG4CPLUS_TEXT ("block"), AsyncOverflowPolicy::block},
+            {LOG4CPLUS_TEXT ("blocktimeout"),
+                AsyncOverflowPolicy::block_timeout},
+            {LOG4CPLUS_TEXT ("dropnewest"), AsyncOverflowPolicy::drop_newest},
+            {LOG4CPLUS_TEXT ("dropoldest"), AsyncOverflowPolicy::drop_oldest},
+            {LOG4CPLUS_TEXT ("dropbelowlevel"),
+                AsyncOverflowPolicy::drop_below_level},
+            {LOG4CPLUS_TEXT ("synchronous"),
+                AsyncOverflowPolicy::synchronous}};
+
+        auto const it = std::find_if (std::begin (policies),
+            std::end (policies),
+            [&] (auto const & p) { return overflowPolicy == p.name; });
+        if (it != std::end (policies))
+        {
+            AsyncOverflow overflow;
+            overflow.policy = it->policy;
+
+            unsigned timeout = 0;
+            if (properties.getUInt (timeout,
+                    LOG4CPLUS_TEXT ("OverflowTimeout")))
+                overflow.timeout = std::chrono::milliseconds (timeout);
+
+            tstring const & level
+                = properties.getProperty (LOG4CPLUS_TEXT ("OverflowLevel"));
+            if (! level.empty ())
+                overflow.level = getLogLevelManager ().fromString (
+                    helpers::toUpper (level));
+
+            setAsyncOverflow (overflow);
+        }
+        else
+            helpers::getLogLog ().warn (
+                LOG4CPLUS_TEXT ("Appender::ctor()- Unknown OverflowPolicy: ")
+                + overflowPolicy);
+    }
+
+    properties.getBool (concurrentFormatting,
+        LOG4CPLUS_TEXT("ConcurrentFormatting"));
 }
 
 
@@ -290,33 +356,190 @@ Appender::subtract_in_flight ()
 #endif
 
 
+#if ! defined (LOG4CPLUS_SINGLE_THREADED) \
+    && defined (LOG4CPLUS_ENABLE_THREAD_POOL)
 // from global-init.cxx
-void enqueueAsyncDoAppend (SharedAppenderPtr const & appender,
-    spi::InternalLoggingEvent const & event);
+void enqueueAsyncTask (std::function<void ()> task);
+std::size_t getAsyncQueueSizeLimit ();
+
+
+namespace
+{
+
+//! Maximal number of events appended by one drain task before it yields
+//! its worker to other appenders.
+std::size_t const ASYNC_STRAND_BATCH = 64;
+
+} // namespace
 
 
 void
-Appender::doAppend(const log4cplus::spi::InternalLoggingEvent& event)
+Appender::queueAsyncDoAppend(const log4cplus::spi::InternalLoggingEvent& event)
 {
-#if ! defined (LOG4CPLUS_SINGLE_THREADED) \
-    && defined (LOG4CPLUS_ENABLE_THREAD_POOL)
-    if (async)
+    internal::AsyncStrand & s = *strand;
+    std::size_t const limit = getAsyncQueueSizeLimit ();
+    bool schedule;
     {
-        event.gatherThreadSpecificData ();
+        std::unique_lock<std::mutex> guard (s.mtx);
+        bool evicted = false;
+        if (s.events.size () >= limit)
+        {
+            AsyncOverflow const overflow = getAsyncOverflow ();
+            auto const hasRoom = [&] { return s.events.size () < limit; };
+            bool drop = false;
+            switch (overflow.policy)
+            {
+            case AsyncOverflowPolicy::block:
+                s.not_full.wait (guard, hasRoom);
+                break;
+
+            case AsyncOverflowPolicy::block_timeout:
+                drop = ! s.not_full.wait_for (guard, overflow.timeout,
+                    hasRoom);
+                break;
+
+            case AsyncOverflowPolicy::drop_newest:
+                drop = true;
+                break;
+
+            case AsyncOverflowPolicy::drop_oldest:
+                s.events.pop_front ();
+                evicted = true;
+                break;
+
+            case AsyncOverflowPolicy::drop_below_level:
+                if (event.getLogLevel () < overflow.level)
+                    drop = true;
+                else if (auto it = std::find_if (s.events.begin (),
+                        s.events.end (),
+                        [&] (spi::InternalLoggingEvent const & queued) {
+                            return queued.getLogLevel () < overflow.level; });
+                    it != s.events.end ())
+                {
+                    s.events.erase (it);
+                    evicted = true;
+                }
+                else
+                    s.not_full.wait (guard, hasRoom);
+                break;
+
+            case AsyncOverflowPolicy::synchronous:
+                guard.unlock ();
+                syncDoAppend (event);
+                return;
+            }
 
+            if (drop)
+            {
+                guard.unlock ();
+                recordDroppedEvent ();
+                return;
+            }
+        }
+
+        // Copy only the fields that the appender reads. The copy captures
+        // thread specific data of this thread.
+        s.events.emplace_back (event, getEventFields ());
         std::atomic_fetch_add_explicit (&in_flight, std::size_t (1),
             std::memory_order_relaxed);
+        schedule = ! std::exchange (s.scheduled, true);
+        guard.unlock ();
+
+        if (evicted)
+        {
+            subtract_in_flight ();
+            recordDroppedEvent ();
+        }
+    }
+
+    if (schedule)
+        scheduleAsyncStrand ();
+}
+
+
+void
+Appender::scheduleAsyncStrand()
+{
+    try
+    {
+        enqueueAsyncTask (
+            [appender = SharedAppenderPtr (this)] {
+                appender->drainAsyncStrand ();
+            });
+    }
+    catch (...)
+    {
+        helpers::getLogLog ().error (
+            LOG4CPLUS_TEXT ("Appender::scheduleAsyncStrand()- failed to")
+            LOG4CPLUS_TEXT (" queue asynchronous append of [") + name
+            + LOG4CPLUS_TEXT ("], appending synchronously"));
+
+        // Nothing else is going to drain the strand, its events would
+        // keep `in_flight` above zero forever. The strand stays scheduled
+        // until it is empty, so the events keep their order.
+        while (appendAsyncBatch ())
+            ;
+    }
+}
+
+
+void
+Appender::drainAsyncStrand()
+{
+    // Queue the rest behind tasks of other appenders so that a busy
+    // appender does not starve them.
+    if (appendAsyncBatch ())
+        scheduleAsyncStrand ();
+}
+
 
+bool
+Appender::appendAsyncBatch()
+{
+    internal::AsyncStrand & s = *strand;
+    std::vector<spi::InternalLoggingEvent> batch;
+    {
+        std::unique_lock<std::mutex> guard (s.mtx);
+        std::size_t const count = (std::min) (s.events.size (),
+            ASYNC_STRAND_BATCH);
+        batch.reserve (count);
+        std::move (s.events.begin (), s.events.begin () + count,
+            std::back_inserter (batch));
+        s.events.erase (s.events.begin (), s.events.begin () + count);
+    }
+    s.not_full.notify_all ();
+
+    for (auto const & ev : batch)
+    {
         try
         {
-            enqueueAsyncDoAppend (SharedAppenderPtr (this), event);
+            asyncDoAppend (ev);
         }
         catch (...)
         {
-            subtract_in_flight ();
-            throw;
+            // Nobody waits for the outcome; keep draining the rest.
         }
     }
+
+    std::unique_lock<std::mutex> guard (s.mtx);
+    if (s.events.empty ())
+    {
+        s.scheduled = false;
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+
+void
+Appender::doAppend(const log4cplus::spi::InternalLoggingEvent& event)
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED) \
+    && defined (LOG4CPLUS_ENABLE_THREAD_POOL)
+    if (async)
+        queueAsyncDoAppend (event);
     else
 #endif
         syncDoAppend (event);
@@ -353,6 +576,12 @@ Appender::asyncDoAppend(const log4cplus::spi::InternalLoggingEvent& event)
 void
 Appender::syncDoAppend(const log4cplus::spi::InternalLoggingEvent& event)
 {
+    if (concurrentFormatting)
+    {
+        concurrentDoAppend (event);
+        return;
+    }
+
     thread::MutexGuard guard (access_mutex);
 
     if(closed) {
@@ -370,9 +599,94 @@ Appender::syncDoAppend(const log4cplus::spi::InternalLoggingEvent& event)
 
     // Evaluate filters attached to this appender.
 
-    if (checkFilter(filter.get(), event) == spi::FilterResult::DENY)
+    {
+        helpers::EpochGuard const epoch_guard;
+        if (FilterSnapshot const * const filters = filterSnapshot.load ();
+            filters
+            && filters->chain.check (event) == spi::FilterResult::DENY)
+            return;
+    }
+
+    appendLocked (event);
+}
+
+
+namespace
+{
+
+//! Forgets output formatted ahead for an event once it has been appended.
+struct formatted_event_guard
+{
+    explicit formatted_event_guard (internal::appender_sratch_pad & sp_)
+        : sp (sp_)
+    { }
+
+    ~formatted_event_guard ()
+    {
+        sp.formatted_by = nullptr;
+        sp.formatted_event = nullptr;
+    }
+
+    internal::appender_sratch_pad & sp;
+};
+
+} // namespace
+
+
+void
+Appender::concurrentDoAppend(const log4cplus::spi::InternalLoggingEvent& event)
+{
+    // Check appender's threshold logging level and evaluate filters
+    // without holding the lock.
+
+    if (! isAsSevereAsThreshold(event.getLogLevel()))
         return;
 
+    {
+        helpers::EpochGuard const epoch_guard;
+        FilterSnapshot const * const filters = filterSnapshot.load ();
+        if (filters
+            && filters->chain.check (event) == spi::FilterResult::DENY)
+            return;
+    }
+
+    // Format the event into this thread's buffer, unless the appender
+    // would not use it.
+
+    internal::appender_sratch_pad & appender_sp = internal::get_appender_sp ();
+    formatted_event_guard fe_guard (appender_sp);
+    if (usesFormattedEvent ())
+    {
+        if (tstring const * shared = getSharedFormat (event))
+            appender_sp.formatted = *shared;
+        else
+        {
+            detail::clear_tostringstream (appender_sp.oss);
+            layout->formatAndAppend(appender_sp.oss, event);
+            appender_sp.formatted = appender_sp.oss.str();
+        }
+
+        appender_sp.formatted_by = this;
+        appender_sp.formatted_event = &event;
+    }
+
+    thread::MutexGuard guard (access_mutex);
+
+    if(closed) {
+        helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("Attempted to append to closed appender named [")
+            + name
+            + LOG4CPLUS_TEXT("]."));
+        return;
+    }
+
+    appendLocked (event);
+}
+
+
+void
+Appender::appendLocked(const log4cplus::spi::InternalLoggingEvent& event)
+{
     // Lock system wide lock.
 
     helpers::LockFileGuard lfguard;
@@ -398,6 +712,16 @@ tstring &
 Appender::formatEvent (const spi::InternalLoggingEvent& event) const
 {
     internal::appender_sratch_pad & appender_sp = internal::get_appender_sp ();
+    if (appender_sp.formatted_by == this
+        && appender_sp.formatted_event == &event)
+        return appender_sp.formatted;
+
+    if (tstring const * shared = getSharedFormat (event))
+    {
+        appender_sp.str = *shared;
+        return appender_sp.str;
+    }
+
     detail::clear_tostringstream (appender_sp.oss);
     layout->formatAndAppend(appender_sp.oss, event);
     appender_sp.str = appender_sp.oss.str();
@@ -405,6 +729,64 @@ Appender::formatEvent (const spi::InternalLoggingEvent& event) const
 }
 
 
+void
+Appender::formatAndAppend (tostream & output,
+    const spi::InternalLoggingEvent& event) const
+{
+    internal::appender_sratch_pad & appender_sp = internal::get_appender_sp ();
+
+    // Text formatted ahead of time, either in concurrentDoAppend() or
+    // for the whole dispatch, used the scratch pad streams' locale.
+    // Reuse it only if the output stream has not been imbued with
+    // another one.
+
+    if (output.getloc () != appender_sp.oss.getloc ())
+        layout->formatAndAppend(output, event);
+    else if (appender_sp.formatted_by == this
+        && appender_sp.formatted_event == &event)
+        output << appender_sp.formatted;
+    else if (tstring const * shared = getSharedFormat (event))
+        output << *shared;
+    else
+        layout->formatAndAppend(output, event);
+}
+
+
+tstring const *
+Appender::getSharedFormat (const spi::InternalLoggingEvent& event) const
+{
+    internal::appender_sratch_pad & appender_sp = internal::get_appender_sp ();
+    if (appender_sp.dispatch_event != &event || ! layout)
+        return nullptr;
+
+    tstring const & key = layout->getFormatKey ();
+    if (key.empty ())
+        return nullptr;
+
+    std::type_info const & layout_type = typeid (*layout);
+    for (std::size_t i = 0; i != appender_sp.dispatch_formats_count; ++i)
+    {
+        auto const & entry = appender_sp.dispatch_formats[i];
+        if (*entry.layout_type == layout_type && entry.key == key)
+            return &entry.text;
+    }
+
+    if (appender_sp.dispatch_formats_count
+        == appender_sp.dispatch_formats.size ())
+        appender_sp.dispatch_formats.emplace_back ();
+
+    auto & entry
+        = appender_sp.dispatch_formats[appender_sp.dispatch_formats_count];
+    detail::clear_tostringstream (appender_sp.dispatch_oss);
+    layout->formatAndAppend(appender_sp.dispatch_oss, event);
+    entry.layout_type = &layout_type;
+    entry.key = key;
+    entry.text = appender_sp.dispatch_oss.str ();
+    ++appender_sp.dispatch_formats_count;
+    return &entry.text;
+}
+
+
 log4cplus::tstring
 Appender::getName()
 {
@@ -453,6 +835,7 @@ Appender::setLayout(std::unique_ptr<Layout> lo)
     thread::MutexGuard guard (access_mutex);
 
     this->layout = std::move(lo);
+    updateEventFields ();
 }
 
 
@@ -472,6 +855,11 @@ Appender::setFilter(log4cplus::spi::FilterPtr f)
     thread::MutexGuard guard (access_mutex);
 
     filter = std::move (f);
+    filterSnapshot.store (filter
+        ? std::make_unique<FilterSnapshot const> (
+            FilterSnapshot {spi::CompiledFilterChain (filter)})
+        : std::unique_ptr<FilterSnapshot const> ());
+    updateEventFields ();
 }
 
 
@@ -489,6 +877,12 @@ Appender::addFilter (log4cplus::spi::FilterPtr f)
 {
     thread::MutexGuard guard (access_mutex);
 
+    // Appending links `f` to the last filter of the current chain. That
+    // is safe with respect to lock free readers in concurrentDoAppend()
+    // because they only ever see published snapshots, which hold the
+    // filters flattened and never follow Filter::next. setFilter()
+    // publishes a new snapshot including `f`.
+
     log4cplus::spi::FilterPtr filterChain = getFilter ();
     if (filterChain)
         filterChain->appendFilter (std::move (f));
@@ -508,4 +902,152 @@ Appender::addFilter (std::function<
 }
 
 
+
+namespace
+{
+
+std::atomic<std::uint64_t> event_fields_epoch {0};
+
+} // namespace
+
+
+unsigned
+Appender::getEventFields() const
+{
+    return spi::EVENT_FIELDS_ALL;
+}
+
+
+void
+Appender::setAsyncOverflow(AsyncOverflow const & overflow)
+{
+    asyncOverflow.store (std::make_unique<AsyncOverflow const> (overflow));
+}
+
+
+// from global-init.cxx
+bool getThreadPoolBlockOnFull ();
+
+
+AsyncOverflow
+Appender::getAsyncOverflow() const
+{
+    AsyncOverflow fallback;
+    if (! getThreadPoolBlockOnFull ())
+        fallback.policy = AsyncOverflowPolicy::drop_newest;
+    return getAsyncOverflowOr (fallback);
+}
+
+
+AsyncOverflow
+Appender::getAsyncOverflowOr(AsyncOverflow const & fallback) const
+{
+    helpers::EpochGuard const guard;
+    if (AsyncOverflow const * const overflow = asyncOverflow.load ())
+        return *overflow;
+
+    return fallback;
+}
+
+
+void
+Appender::recordDroppedEvent()
+{
+    static helpers::SteadyClockGate gate (
+        helpers::SteadyClockGate::Duration {std::chrono::minutes (5)});
+
+    droppedEvents.fetch_add (1, std::memory_order_relaxed);
+
+    gate.record_event ();
+    helpers::SteadyClockGate::Info info;
+    if (gate.latch_open (info))
+    {
+        helpers::LogLog & loglog = helpers::getLogLog ();
+        log4cplus::tostringstream oss;
+        oss << LOG4CPLUS_TEXT ("Asynchronous logging queue is full. Dropped ")
+            << info.count << LOG4CPLUS_TEXT (" events in last ")
+            << std::chrono::duration_cast<std::chrono::seconds> (
+                info.time_span).count ()
+            << LOG4CPLUS_TEXT (" seconds");
+        loglog.warn (oss.str ());
+    }
+}
+
+
+std::uint64_t
+Appender::getEventFieldsEpoch()
+{
+    return event_fields_epoch.load (std::memory_order_acquire);
+}
+
+
+void
+Appender::updateEventFields()
+{
+    unsigned const fields = (layout
+            ? layout->getEventFields () : spi::EVENT_FIELDS_NONE)
+        | spi::getFilterEventFields (filter.get ());
+    layoutEventFields.store (fields, std::memory_order_relaxed);
+    event_fields_epoch.fetch_add (1, std::memory_order_acq_rel);
+}
+
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS) \
+    && ! defined (LOG4CPLUS_SINGLE_THREADED) \
+    && defined (LOG4CPLUS_ENABLE_THREAD_POOL)
+namespace
+{
+
+class RecordingAppender
+    : public Appender
+{
+public:
+    explicit RecordingAppender (helpers::Properties const & props)
+        : Appender (props)
+    { }
+
+    ~RecordingAppender () override
+    {
+        destructorImpl ();
+    }
+
+    void close () override
+    {
+        closed = true;
+    }
+
+    std::vector<tstring> messages;
+
+protected:
+    void append (spi::InternalLoggingEvent const & event) override
+    {
+        messages.push_back (event.getMessage ());
+    }
+};
+
+} // namespace
+
+
+CATCH_TEST_CASE ("Asynchronous append keeps order", "[appender]")
+{
+    helpers::Properties props;
+    props.setProperty (LOG4CPLUS_TEXT ("AsyncAppend"), LOG4CPLUS_TEXT ("true"));
+    helpers::SharedObjectPtr<RecordingAppender> const appender (
+        new RecordingAppender (props));
+
+    std::vector<tstring> expected;
+    for (int i = 0; i != 5000; ++i)
+    {
+        expected.push_back (helpers::convertIntegerToString (i));
+        spi::InternalLoggingEvent const event (LOG4CPLUS_TEXT ("strand"),
+            INFO_LOG_LEVEL, expected.back (), __FILE__, __LINE__);
+        appender->doAppend (event);
+    }
+    appender->waitToFinishAsyncLogging ();
+
+    CATCH_REQUIRE (appender->messages == expected);
+}
+#endif
+
+
 } // namespace log4cplus
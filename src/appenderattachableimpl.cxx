@@ -26,6 +26,7 @@
 #include <log4cplus/thread/syncprims-pub-impl.h>
 
 #include <algorithm>
+#include <iterator>
 
 
 namespace log4cplus
@@ -72,11 +73,22 @@ AppenderAttachableImpl::addAppender(SharedAppenderPtr newAppender)
 
     thread::MutexGuard guard (appender_list_mutex);
 
-    auto it = std::find(appenderList.begin(), appenderList.end(), newAppender);
-    if (it == appenderList.end())
+    // Only writers replace the list and they hold the mutex, so the
+    // current list cannot go away here.
+    ListType const * const current = appenderList.load ();
+    if (current && std::find (current->begin (), current->end (), newAppender)
+        != current->end ())
+        return;
+
+    auto updated = std::make_unique<ListType> ();
+    if (current)
     {
-        appenderList.push_back(newAppender);
+        updated->reserve (current->size () + 1);
+        updated->assign (current->begin (), current->end ());
     }
+
+    updated->push_back(newAppender);
+    appenderList.store (std::move (updated));
 }
 
 
@@ -84,9 +96,12 @@ AppenderAttachableImpl::addAppender(SharedAppenderPtr newAppender)
 AppenderAttachableImpl::ListType
 AppenderAttachableImpl::getAllAppenders()
 {
-    thread::MutexGuard guard (appender_list_mutex);
-
-    return appenderList;
+    EpochGuard const epoch_guard;
+    ListType const * const current = appenderList.load ();
+    if (current)
+        return *current;
+    else
+        return ListType ();
 }
 
 
@@ -94,9 +109,12 @@ AppenderAttachableImpl::getAllAppenders()
 SharedAppenderPtr
 AppenderAttachableImpl::getAppender(const log4cplus::tstring& name)
 {
-    thread::MutexGuard guard (appender_list_mutex);
+    EpochGuard const epoch_guard;
+    ListType const * const current = appenderList.load ();
+    if (! current)
+        return SharedAppenderPtr ();
 
-    for (SharedAppenderPtr & ptr : appenderList)
+    for (SharedAppenderPtr const & ptr : *current)
     {
         if (ptr->getName() == name)
             return ptr;
@@ -112,14 +130,23 @@ AppenderAttachableImpl::removeAllAppenders()
 {
     thread::MutexGuard guard (appender_list_mutex);
 
+    std::unique_ptr<ListType const> old = appenderList.exchange (
+        std::unique_ptr<ListType const> ());
+    if (! old)
+        return;
+
     // Clear appenders in specific order because the order of destruction of
     // std::vector elements is surprisingly unspecified and it breaks our
-    // tests' expectations.
-
-    for (auto & app : appenderList)
-        app = SharedAppenderPtr ();
-
-    appenderList.clear ();
+    // tests' expectations. Readers may still be iterating the list, so
+    // that happens only once they are done. Snapshots are allocated
+    // non-const, modifying them once unpublished is fine.
+
+    retireSnapshot (old.release (), [] (void const * p) {
+        std::unique_ptr<ListType> list (
+            const_cast<ListType *>(static_cast<ListType const *>(p)));
+        for (auto & app : *list)
+            app = SharedAppenderPtr ();
+    });
 }
 
 
@@ -135,11 +162,25 @@ AppenderAttachableImpl::removeAppender(SharedAppenderPtr appender)
 
     thread::MutexGuard guard (appender_list_mutex);
 
-    auto it = std::find(appenderList.begin(), appenderList.end(), appender);
-    if (it != appenderList.end())
+    ListType const * const current = appenderList.load ();
+    if (! current)
+        return;
+
+    auto it = std::find(current->begin(), current->end(), appender);
+    if (it == current->end())
+        return;
+
+    std::unique_ptr<ListType> updated;
+    if (current->size () != 1)
     {
-        appenderList.erase(it);
+        updated = std::make_unique<ListType> ();
+        updated->reserve (current->size () - 1);
+        updated->insert (updated->end (), current->cbegin (),
+            ListType::const_iterator (it));
+        updated->insert (updated->end (), std::next (
+            ListType::const_iterator (it)), current->cend ());
     }
+    appenderList.store (std::move (updated));
 }
 
 
@@ -155,11 +196,13 @@ AppenderAttachableImpl::removeAppender(const log4cplus::tstring& name)
 int
 AppenderAttachableImpl::appendLoopOnAppenders(const spi::InternalLoggingEvent& event) const
 {
-    int count = 0;
-
-    thread::MutexGuard guard (appender_list_mutex);
+    EpochGuard const epoch_guard;
+    ListType const * const current = appenderList.load ();
+    if (! current)
+        return 0;
 
-    for (auto & appender : appenderList)
+    int count = 0;
+    for (auto & appender : *current)
     {
         ++count;
         appender->doAppend(event);
@@ -30,6 +30,7 @@
 #include <log4cplus/spi/factory.h>
 #include <log4cplus/helpers/loglog.h>
 #include <log4cplus/helpers/property.h>
+#include <log4cplus/helpers/stringhelper.h>
 #include <log4cplus/thread/syncprims-pub-impl.h>
 
 
@@ -132,6 +133,16 @@ AsyncAppender::AsyncAppender (helpers::Properties const & props)
     props.getUInt (queue_len, LOG4CPLUS_TEXT ("QueueLimit"));
 
     init_queue_thread (queue_len);
+
+    tstring const & priority_level
+        = props.getProperty (LOG4CPLUS_TEXT ("PriorityLevel"));
+    if (! priority_level.empty ())
+    {
+        bool merge = false;
+        props.getBool (merge, LOG4CPLUS_TEXT ("MergeLanes"));
+        setPriorityLane (getLogLevelManager ().fromString (
+            helpers::toUpper (priority_level)), merge);
+    }
 }
 
 
@@ -151,6 +162,14 @@ AsyncAppender::init_queue_thread (unsigned queue_len)
 }
 
 
+void
+AsyncAppender::setPriorityLane (LogLevel level, bool merge)
+{
+    if (queue)
+        queue->set_priority_lane (level, merge);
+}
+
+
 void
 AsyncAppender::close ()
 {
@@ -177,8 +196,16 @@ AsyncAppender::append (spi::InternalLoggingEvent const & ev)
 {
     if (queue_thread && queue_thread->isRunning ())
     {
-        unsigned ret = queue->put_event (ev);
-        if (ret & (thread::Queue::ERROR_BIT | thread::Queue::ERROR_AFTER))
+        // Thread pool settings do not apply to this appender's own
+        // queue, it blocks unless told otherwise.
+        unsigned ret = queue->put_event (ev,
+            getAsyncOverflowOr (AsyncOverflow ()));
+        if (ret & thread::Queue::DROPPED)
+            recordDroppedEvent ();
+
+        if (ret & thread::Queue::FULL)
+            appendLoopOnAppenders (ev);
+        else if (ret & (thread::Queue::ERROR_BIT | thread::Queue::ERROR_AFTER))
         {
             getErrorHandler ()->error (
                 LOG4CPLUS_TEXT ("Error in AsyncAppender::append,")
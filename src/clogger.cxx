@@ -24,6 +24,7 @@
 #include <log4cplus/hierarchylocker.h>
 #include <log4cplus/hierarchy.h>
 #include <log4cplus/helpers/loglog.h>
+#include <log4cplus/helpers/snapshot.h>
 #include <log4cplus/spi/loggerimpl.h>
 #include <log4cplus/configurator.h>
 #include <log4cplus/streams.h>
@@ -37,6 +38,7 @@
 #include <cstdio>
 #include <cstdarg>
 #include <cstring>
+#include <memory>
 
 #include <sstream>
 #include <map>
@@ -395,27 +397,34 @@ CustomLogLevelManager::~CustomLogLevelManager () = default;
 bool
 CustomLogLevelManager::add(LogLevel ll, tstring const &nm)
 {
+    bool push;
+    {
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    std::unique_lock guard (mtx);
+        std::unique_lock guard (mtx);
 #endif
 
-    if (! pushed_methods)
-    {
-        pushed_methods = true;
-        getLogLevelManager().pushLogLevelTranslator (SharedLogLevelTranslatorPtr (this));
-    }
+        auto i = ll2nm.lower_bound(ll);
+        if( ( i != ll2nm.end() ) && ( i->first == ll ) && ( i->second != nm ) )
+            return false;
 
-    auto i = ll2nm.lower_bound(ll);
-    if( ( i != ll2nm.end() ) && ( i->first == ll ) && ( i->second != nm ) )
-        return false;
+        auto j = nm2ll.lower_bound(nm);
+        if( ( j != nm2ll.end() ) && ( j->first == nm ) && ( j->second != ll ) )
+            return false;
 
-    auto j = nm2ll.lower_bound(nm);
-    if( ( j != nm2ll.end() ) && ( j->first == nm ) && ( j->second != ll ) )
-        return false;
+        // there is no else after return
+        ll2nm.insert( i, std::make_pair(ll, nm) );
+        nm2ll.insert( j, std::make_pair(nm, ll) );
 
-    // there is no else after return
-    ll2nm.insert( i, std::make_pair(ll, nm) );
-    nm2ll.insert( j, std::make_pair(nm, ll) );
+        push = ! pushed_methods;
+        pushed_methods = true;
+    }
+
+    // LogLevelManager queries this translator while it rebuilds its
+    // lookup table, so this must be done without holding `mtx`.
+    if (push)
+        getLogLevelManager().pushLogLevelTranslator (SharedLogLevelTranslatorPtr (this));
+    else
+        getLogLevelManager().reloadLogLevelTranslators ();
 
     return true;
 }
@@ -424,22 +433,30 @@ CustomLogLevelManager::add(LogLevel ll, tstring const &nm)
 bool
 CustomLogLevelManager::remove(LogLevel ll, tstring const &nm)
 {
+    typedef decltype (ll2nm)::node_type name_node;
+    std::unique_ptr<name_node> removed;
+    {
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    std::unique_lock guard (mtx);
+        std::unique_lock guard (mtx);
 #endif
 
-    auto i = ll2nm.find(ll);
-    auto j = nm2ll.find(nm);
-    if( ( i != ll2nm.end() ) && ( j != nm2ll.end() ) &&
-        ( i->first == j->second ) && ( i->second == j->first ) ) {
-        ll2nm.erase(i);
-        nm2ll.erase(j);
+        auto i = ll2nm.find(ll);
+        auto j = nm2ll.find(nm);
+        if( ( i == ll2nm.end() ) || ( j == nm2ll.end() ) ||
+            ( i->first != j->second ) || ( i->second != j->first ) )
+            return false;
 
-        return true;
+        removed = std::make_unique<name_node> (ll2nm.extract(i));
+        nm2ll.erase(j);
     }
 
-    // there is no else after return
-    return false;
+    // LogLevelManager::toString() copies names it gets from this
+    // translator while holding an EpochGuard. Free the removed name only
+    // once no such copy can be in progress.
+    getLogLevelManager().reloadLogLevelTranslators ();
+    helpers::retireSnapshot (removed.release (),
+        [] (void const * p) { delete static_cast<name_node const *>(p); });
+    return true;
 }
 
 
@@ -19,7 +19,6 @@
 // limitations under the License.
 
 #include <log4cplus/configurator.h>
-#include <log4cplus/hierarchylocker.h>
 #include <log4cplus/hierarchy.h>
 #include <log4cplus/helpers/loglog.h>
 #include <log4cplus/helpers/stringhelper.h>
@@ -30,6 +29,7 @@
 #include <log4cplus/thread/syncprims-pub-impl.h>
 #include <log4cplus/spi/factory.h>
 #include <log4cplus/spi/loggerimpl.h>
+#include <log4cplus/spi/loggingevent.h>
 #include <log4cplus/internal/env.h>
 
 #ifdef LOG4CPLUS_HAVE_SYS_TYPES_H
@@ -45,12 +45,32 @@
 #if defined (_WIN32)
 #include <tchar.h>
 #endif
+#if defined (LOG4CPLUS_HAVE_SYS_INOTIFY_H) && !defined (LOG4CPLUS_SINGLE_THREADED)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <climits>
+#define LOG4CPLUS_WATCH_WITH_INOTIFY
+#endif
 
 #include <algorithm>
 #include <cstdlib>
 #include <iterator>
 #include <sstream>
 
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <log4cplus/fileappender.h>
+#include <log4cplus/fstreams.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <catch_amalgamated.hpp>
+#endif
+
 
 namespace log4cplus
 {
@@ -176,36 +196,11 @@ PropertyConfigurator::doConfigure(const tstring& file, Hierarchy& h,
 void
 PropertyConfigurator::configure()
 {
-    // Configure log4cplus internals.
-    bool internal_debugging = false;
-    if (properties.getBool (internal_debugging, LOG4CPLUS_TEXT ("configDebug")))
-        helpers::getLogLog ().setInternalDebugging (internal_debugging);
-
-    bool quiet_mode = false;
-    if (properties.getBool (quiet_mode, LOG4CPLUS_TEXT ("quietMode")))
-        helpers::getLogLog ().setQuietMode (quiet_mode);
+    configureInternals();
 
     bool disable_override = false;
     properties.getBool (disable_override, LOG4CPLUS_TEXT ("disableOverride"));
 
-    initializeLog4cplus();
-
-    unsigned int thread_pool_size;
-    if (properties.getUInt (thread_pool_size, LOG4CPLUS_TEXT ("threadPoolSize")))
-        thread_pool_size = (std::min) (thread_pool_size, 1024U);
-    else
-        thread_pool_size = 4;
-
-    setThreadPoolSize (thread_pool_size);
-
-    bool block;
-    if (properties.getBool (block, LOG4CPLUS_TEXT ("threadPoolBlockOnFull")))
-        setThreadPoolBlockOnFull (block);
-
-    unsigned int queue_size_limit;
-    if (properties.getUInt (queue_size_limit, LOG4CPLUS_TEXT ("threadPoolQueueSizeLimit")))
-        setThreadPoolQueueSizeLimit ((std::max) (queue_size_limit, 100u));
-
     configureAppenders();
     configureLoggers();
     configureAdditivity();
@@ -238,6 +233,60 @@ PropertyConfigurator::getPropertyFilename () const
 // PropertyConfigurator protected methods
 //////////////////////////////////////////////////////////////////////////////
 
+void
+PropertyConfigurator::configureInternals()
+{
+    // Configure log4cplus internals.
+    bool internal_debugging = false;
+    if (properties.getBool (internal_debugging, LOG4CPLUS_TEXT ("configDebug")))
+        helpers::getLogLog ().setInternalDebugging (internal_debugging);
+
+    bool quiet_mode = false;
+    if (properties.getBool (quiet_mode, LOG4CPLUS_TEXT ("quietMode")))
+        helpers::getLogLog ().setQuietMode (quiet_mode);
+
+    initializeLog4cplus();
+
+    unsigned int thread_pool_size;
+    if (properties.getUInt (thread_pool_size, LOG4CPLUS_TEXT ("threadPoolSize")))
+        setThreadPoolSize ((std::min) (thread_pool_size, 1024U));
+
+    if (properties.getUInt (thread_pool_size, LOG4CPLUS_TEXT ("threadPoolMinSize")))
+        setThreadPoolMinSize ((std::min) (thread_pool_size, 1024U));
+
+    if (properties.getUInt (thread_pool_size, LOG4CPLUS_TEXT ("threadPoolMaxSize")))
+        setThreadPoolMaxSize ((std::min) (thread_pool_size, 1024U));
+
+    unsigned int idle_timeout;
+    if (properties.getUInt (idle_timeout, LOG4CPLUS_TEXT ("threadPoolIdleTimeout")))
+        setThreadPoolIdleTimeout (std::chrono::seconds (idle_timeout));
+
+    unsigned int queue_depth = 2;
+    unsigned int latency = 10;
+    bool const has_depth = properties.getUInt (queue_depth,
+        LOG4CPLUS_TEXT ("threadPoolScaleUpQueueDepth"));
+    bool const has_latency = properties.getUInt (latency,
+        LOG4CPLUS_TEXT ("threadPoolScaleUpLatency"));
+    if (has_depth || has_latency)
+        setThreadPoolScaleUpThresholds (queue_depth,
+            std::chrono::milliseconds (latency));
+
+    bool block;
+    if (properties.getBool (block, LOG4CPLUS_TEXT ("threadPoolBlockOnFull")))
+        setThreadPoolBlockOnFull (block);
+
+    unsigned int queue_size_limit;
+    if (properties.getUInt (queue_size_limit, LOG4CPLUS_TEXT ("threadPoolQueueSizeLimit")))
+        setThreadPoolQueueSizeLimit ((std::max) (queue_size_limit, 100u));
+
+    unsigned int task_queue_size_limit;
+    if (properties.getUInt (task_queue_size_limit,
+            LOG4CPLUS_TEXT ("threadPoolTaskQueueSizeLimit")))
+        setThreadPoolTaskQueueSizeLimit (
+            (std::max) (task_queue_size_limit, 1u));
+}
+
+
 void
 PropertyConfigurator::reconfigure()
 {
@@ -252,6 +301,7 @@ PropertyConfigurator::replaceEnvironVariables()
 {
     tstring val, subKey, subVal;
     std::vector<tstring> keys;
+    helpers::SubstVarsCache envCache;
     bool const rec_exp
         = !! (flags & PropertyConfigurator::fRecursiveExpansion);
     bool changed;
@@ -265,7 +315,8 @@ PropertyConfigurator::replaceEnvironVariables()
             val = properties.getProperty(key);
 
             subKey.clear ();
-            if (helpers::substVars(subKey, key, properties, helpers::getLogLog(), flags))
+            if (helpers::substVars(subKey, key, properties,
+                    helpers::getLogLog(), flags, &envCache))
             {
                 properties.removeProperty(key);
                 properties.setProperty(subKey, val);
@@ -273,7 +324,8 @@ PropertyConfigurator::replaceEnvironVariables()
             }
 
             subVal.clear ();
-            if (helpers::substVars(subVal, val, properties, helpers::getLogLog(), flags))
+            if (helpers::substVars(subVal, val, properties,
+                    helpers::getLogLog(), flags, &envCache))
             {
                 properties.setProperty(subKey, subVal);
                 changed = true;
@@ -340,10 +392,8 @@ PropertyConfigurator::configureLogger(Logger logger, const tstring& config)
     else
         logger.setLogLevel (NOT_SET_LOG_LEVEL);
 
-    // Remove all existing appenders first so that we do not duplicate output.
-    logger.removeAllAppenders ();
-
-    // Set the Appenders
+    // Collect the Appenders
+    SharedAppenderPtrList configured;
     for(std::vector<tstring>::size_type j=1; j<tokens.size(); ++j)
     {
         auto appenderIt = appenders.find(tokens[j]);
@@ -355,69 +405,287 @@ PropertyConfigurator::configureLogger(Logger logger, const tstring& config)
                 + tokens[j]);
             continue;
         }
-        addAppender(logger, appenderIt->second);
+        configured.push_back(appenderIt->second);
     }
+
+    // Remove existing appenders which are not configured so that we do
+    // not duplicate output. Appenders which are configured again stay
+    // attached, events logged meanwhile are not lost.
+    for (SharedAppenderPtr & appender : logger.getAllAppenders ())
+        if (std::find (configured.begin (), configured.end (), appender)
+            == configured.end ())
+            logger.removeAppender (appender);
+
+    // Set the Appenders
+    for (SharedAppenderPtr & appender : configured)
+        addAppender(logger, appender);
 }
 
 
 
-void
-PropertyConfigurator::configureAppenders()
+namespace
 {
-    helpers::Properties appenderProperties =
-        properties.getPropertySubset(LOG4CPLUS_TEXT("appender."));
-    std::vector<tstring> appendersProps = appenderProperties.propertyNames();
-    tstring factoryName;
-    for (tstring & appenderName : appendersProps)
+
+//! Creates the filter chain configured for an appender the way
+//! Appender's constructor does. Configuration errors result in empty
+//! chain; they are reported by the appender itself.
+spi::FilterPtr
+createFilters (helpers::Properties const & props)
+{
+    helpers::Properties const filterProps
+        = props.getPropertySubset (LOG4CPLUS_TEXT ("filters."));
+    spi::FilterPtr filters;
+    unsigned filterCount = 0;
+    tstring filterName;
+    while (filterProps.exists (
+        filterName = helpers::convertIntegerToString (++filterCount)))
     {
-        if (appenderName.find (LOG4CPLUS_TEXT('.')) == tstring::npos)
+        spi::FilterFactory * const factory = spi::getFilterFactoryRegistry ()
+            .get (filterProps.getProperty (filterName));
+        if (! factory)
+            return spi::FilterPtr ();
+
+        spi::FilterPtr filter = factory->createObject (
+            filterProps.getPropertySubset (filterName + LOG4CPLUS_TEXT (".")));
+        if (! filter)
+            return spi::FilterPtr ();
+
+        if (filters)
+            filters->appendFilter (std::move (filter));
+        else
+            filters = std::move (filter);
+    }
+
+    return filters;
+}
+
+
+//! Stands in for an appender configured with `Activation=Lazy`. The real
+//! appender is created by the factory when the first event that passes
+//! the threshold and the filters is appended and the events are passed
+//! on to it from then on. The real appender evaluates the threshold and
+//! the filters itself, the stand-in uses them only to decide about
+//! activation.
+class LazyAppender
+    : public Appender
+{
+public:
+    LazyAppender (tstring const & appenderName,
+        spi::AppenderFactory & factory_, helpers::Properties props_)
+        : factory (factory_)
+        , props (std::move (props_))
+    {
+        setName (appenderName);
+
+        tstring const & thresholdStr
+            = props.getProperty (LOG4CPLUS_TEXT ("Threshold"));
+        if (! thresholdStr.empty ())
+            setThreshold (getLogLevelManager ().fromString (
+                helpers::toUpper (thresholdStr)));
+    }
+
+    ~LazyAppender () override
+    {
+        destructorImpl ();
+    }
+
+    void close () override
+    {
+        thread::MutexGuard guard (access_mutex);
+
+        if (target)
         {
-            factoryName = appenderProperties.getProperty(appenderName);
-            spi::AppenderFactory* factory
-                = spi::getAppenderFactoryRegistry().get(factoryName);
-            if (! factory)
-            {
-                helpers::getLogLog().error(
-                    LOG4CPLUS_TEXT("PropertyConfigurator::configureAppenders()")
-                    LOG4CPLUS_TEXT("- Cannot find AppenderFactory: ")
-                    + factoryName);
-                continue;
-            }
+            target->waitToFinishAsyncLogging ();
+            target->close ();
+        }
+        closed = true;
+    }
+
+    unsigned getEventFields () const override
+    {
+        // Fields read by the real appender are not known before it exists.
+        Appender const * const appender
+            = active.load (std::memory_order_acquire);
+        return appender ? appender->getEventFields () : spi::EVENT_FIELDS_ALL;
+    }
+
+    //! Returns the real appender, activating it if needed.
+    SharedAppenderPtr getTarget ()
+    {
+        thread::MutexGuard guard (access_mutex);
 
-            helpers::Properties props_subset
-                = appenderProperties.getPropertySubset(appenderName
-                + LOG4CPLUS_TEXT("."));
+        if (! target && ! failed && ! closed)
+            activate ();
+
+        return target;
+    }
+
+protected:
+    void append (spi::InternalLoggingEvent const & event) override
+    {
+        if (! target && ! failed)
+        {
+            if (! passesFilters (event))
+                return;
+
+            activate ();
+        }
+
+        if (target)
+            target->doAppend (event);
+    }
+
+private:
+    bool passesFilters (spi::InternalLoggingEvent const & event)
+    {
+        if (! filtersCreated)
+        {
+            filtersCreated = true;
             try
             {
-                SharedAppenderPtr appender
-                    = factory->createObject(props_subset);
-                if (! appender)
-                {
-                    helpers::getLogLog().error(
-                        LOG4CPLUS_TEXT("PropertyConfigurator::")
-                        LOG4CPLUS_TEXT("configureAppenders()")
-                        LOG4CPLUS_TEXT("- Failed to create Appender: ")
-                        + appenderName);
-                }
-                else
-                {
-                    appender->setName(appenderName);
-                    appenders[std::move (appenderName)] = appender;
-                }
+                filters = createFilters (props);
             }
-            catch(std::exception const & e)
+            catch (std::exception const &)
             {
-                helpers::getLogLog().error(
-                    LOG4CPLUS_TEXT("PropertyConfigurator::")
-                    LOG4CPLUS_TEXT("configureAppenders()")
-                    LOG4CPLUS_TEXT("- Error while creating Appender: ")
-                    + LOG4CPLUS_C_STR_TO_TSTRING(e.what()));
+                // Left for the real appender to report on activation.
             }
         }
+
+        return spi::checkFilter (filters.get (), event)
+            != spi::FilterResult::DENY;
+    }
+
+    void activate ()
+    {
+        try
+        {
+            target = factory.createObject (props);
+        }
+        catch (std::exception const & e)
+        {
+            helpers::getLogLog ().error (
+                LOG4CPLUS_TEXT ("LazyAppender::activate()")
+                LOG4CPLUS_TEXT ("- Error while creating Appender: ")
+                + LOG4CPLUS_C_STR_TO_TSTRING (e.what ()));
+        }
+
+        if (! target)
+        {
+            helpers::getLogLog ().error (
+                LOG4CPLUS_TEXT ("LazyAppender::activate()")
+                LOG4CPLUS_TEXT ("- Failed to create Appender: ") + name);
+            failed = true;
+            return;
+        }
+
+        target->setName (name);
+        filters = spi::FilterPtr ();
+        active.store (target.get (), std::memory_order_release);
+
+        // Let loggers narrow fields they capture for this appender.
+        updateEventFields ();
+    }
+
+    spi::AppenderFactory & factory;
+    helpers::Properties const props;
+    SharedAppenderPtr target;
+    std::atomic<Appender *> active {nullptr};
+    spi::FilterPtr filters;
+    bool filtersCreated = false;
+    bool failed = false;
+};
+
+} // namespace
+
+
+SharedAppenderPtr
+PropertyConfigurator::getActivatedAppender (SharedAppenderPtr const & appender)
+{
+    if (auto * const lazy = dynamic_cast<LazyAppender *> (appender.get ()))
+        return lazy->getTarget ();
+
+    return appender;
+}
+
+
+void
+PropertyConfigurator::configureAppenders()
+{
+    helpers::Properties appenderProperties =
+        properties.getPropertySubset(LOG4CPLUS_TEXT("appender."));
+    std::vector<tstring> appendersProps = appenderProperties.propertyNames();
+    for (tstring const & appenderName : appendersProps)
+    {
+        if (appenderName.find (LOG4CPLUS_TEXT('.')) == tstring::npos)
+            configureAppender(appenderName, appenderProperties);
     } // end for loop
 }
 
 
+void
+PropertyConfigurator::configureAppender(const tstring& appenderName,
+    const helpers::Properties& appenderProperties)
+{
+    tstring const & factoryName = appenderProperties.getProperty(appenderName);
+    spi::AppenderFactory* factory
+        = spi::getAppenderFactoryRegistry().get(factoryName);
+    if (! factory)
+    {
+        helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("PropertyConfigurator::configureAppenders()")
+            LOG4CPLUS_TEXT("- Cannot find AppenderFactory: ")
+            + factoryName);
+        return;
+    }
+
+    helpers::Properties props_subset
+        = appenderProperties.getPropertySubset(appenderName
+        + LOG4CPLUS_TEXT("."));
+
+    tstring const activation = helpers::toLower (
+        props_subset.getProperty (LOG4CPLUS_TEXT ("Activation")));
+    if (activation == LOG4CPLUS_TEXT ("lazy"))
+    {
+        appenders[appenderName] = SharedAppenderPtr (
+            new LazyAppender (appenderName, *factory,
+                std::move (props_subset)));
+        return;
+    }
+    else if (! activation.empty () && activation != LOG4CPLUS_TEXT ("eager"))
+        helpers::getLogLog().warn(
+            LOG4CPLUS_TEXT("PropertyConfigurator::configureAppenders()")
+            LOG4CPLUS_TEXT("- Unknown Activation of appender ")
+            + appenderName + LOG4CPLUS_TEXT(": ") + activation);
+
+    try
+    {
+        SharedAppenderPtr appender
+            = factory->createObject(props_subset);
+        if (! appender)
+        {
+            helpers::getLogLog().error(
+                LOG4CPLUS_TEXT("PropertyConfigurator::")
+                LOG4CPLUS_TEXT("configureAppenders()")
+                LOG4CPLUS_TEXT("- Failed to create Appender: ")
+                + appenderName);
+        }
+        else
+        {
+            appender->setName(appenderName);
+            appenders[appenderName] = appender;
+        }
+    }
+    catch(std::exception const & e)
+    {
+        helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("PropertyConfigurator::")
+            LOG4CPLUS_TEXT("configureAppenders()")
+            LOG4CPLUS_TEXT("- Error while creating Appender: ")
+            + LOG4CPLUS_C_STR_TO_TSTRING(e.what()));
+    }
+}
+
+
 void
 PropertyConfigurator::configureAdditivity()
 {
@@ -504,31 +772,52 @@ public:
         : PropertyConfigurator(file)
         , waitMillis(millis < 1000 ? 1000 : millis)
         , shouldTerminate(false)
-        , lock(nullptr)
     {
         lastFileInfo.mtime = helpers::now ();
         lastFileInfo.size = 0;
         lastFileInfo.is_link = false;
 
         updateLastModInfo();
+
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+        initInotify ();
+#endif
     }
 
-    ~ConfigurationWatchDogThread () override = default;
+    ~ConfigurationWatchDogThread () override
+    {
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+        for (int fd : { inotifyFd, wakeUpPipe[0], wakeUpPipe[1] })
+            if (fd != -1)
+                ::close (fd);
+#endif
+    }
 
     void terminate ()
     {
         shouldTerminate.signal ();
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+        if (wakeUpPipe[1] != -1)
+        {
+            char const c = 0;
+            [[maybe_unused]] ssize_t ret = ::write (wakeUpPipe[1], &c, 1);
+        }
+#endif
         join ();
     }
 
 protected:
     void run() override;
-    Logger getLogger(const tstring& name) override;
-    void addAppender(Logger &logger, SharedAppenderPtr& appender) override;
 
+    void reconfigureIncrementally();
     bool checkForFileModification();
     void updateLastModInfo();
 
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+    void initInotify();
+    bool watchWithInotify();
+#endif
+
 private:
     ConfigurationWatchDogThread (ConfigurationWatchDogThread const &) = delete;
     ConfigurationWatchDogThread & operator = (
@@ -537,51 +826,413 @@ private:
     unsigned int const waitMillis;
     thread::ManualResetEvent shouldTerminate;
     helpers::FileInfo lastFileInfo;
-    HierarchyLocker* lock;
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+    int inotifyFd = -1;
+    //! Names of directory entries that lead to the configuration file.
+    std::vector<std::string> watchedNames;
+    //! Written to by terminate() to interrupt poll() in watchWithInotify().
+    int wakeUpPipe[2] = { -1, -1 };
+#endif
 };
 
 
 void
 ConfigurationWatchDogThread::run()
 {
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+    if (watchWithInotify ())
+        return;
+
+    helpers::getLogLog ().debug (
+        LOG4CPLUS_TEXT ("ConfigurationWatchDogThread: inotify is not")
+        LOG4CPLUS_TEXT (" available, polling configuration file every ")
+        + helpers::convertIntegerToString (waitMillis)
+        + LOG4CPLUS_TEXT (" ms"));
+#endif
+
     while (! shouldTerminate.timed_wait (waitMillis))
     {
         bool modified = checkForFileModification();
         if(modified) {
-            // Lock the Hierarchy
-            HierarchyLocker theLock(h);
-            lock = &theLock;
-
-            // reconfigure the Hierarchy
-            theLock.resetConfiguration();
-            reconfigure();
+            reconfigureIncrementally();
             updateLastModInfo();
-
-            // release the lock
-            lock = nullptr;
         }
     }
 }
 
 
-Logger
-ConfigurationWatchDogThread::getLogger(const tstring& name)
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+namespace
+{
+
+//! Quiet period that has to pass after the last inotify event before the
+//! configuration file is re-read. Editors and `kubectl` replace files in
+//! several steps, this coalesces them into single reconfiguration.
+int const INOTIFY_QUIET_MILLIS = 100;
+
+//! Upper bound of coalescing, so that a file that is written to all the
+//! time is still re-read.
+int const INOTIFY_MAX_COALESCE_ROUNDS = 20;
+
+
+std::string
+directoryOf (std::string const & path)
 {
-    if(lock)
-        return lock->getInstance(name);
+    std::string::size_type const slash = path.rfind ('/');
+    if (slash == std::string::npos)
+        return ".";
+    else if (slash == 0)
+        return "/";
     else
-        return PropertyConfigurator::getLogger(name);
+        return path.substr (0, slash);
 }
 
 
+//! Adds watches for directories containing the configuration file and
+//! every symbolic link on the way to the actual file. Watching the
+//! directories instead of the file catches atomic replacements by
+//! rename(), including Kubernetes ConfigMap volumes where
+//! `file -> ..data/file` and the `..data` symlink itself is swapped.
+//! Returns names of directory entries whose change is relevant.
+std::vector<std::string>
+addInotifyWatches (int fd, std::string path)
+{
+    std::vector<std::string> names;
+    uint32_t const mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM
+        | IN_CREATE | IN_DELETE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+
+    // Limit the number of followed links to stay clear of link cycles.
+    for (int hop = 0; hop != 8; ++hop)
+    {
+        std::string const dir = directoryOf (path);
+        if (inotify_add_watch (fd, dir.c_str (), mask) == -1)
+            helpers::getLogLog ().warn (
+                LOG4CPLUS_TEXT ("ConfigurationWatchDogThread: cannot watch ")
+                + LOG4CPLUS_STRING_TO_TSTRING (dir) + LOG4CPLUS_TEXT (": ")
+                + helpers::convertIntegerToString (errno));
+        names.push_back (path.substr (path.rfind ('/') + 1));
+
+        char target[PATH_MAX];
+        ssize_t const len = readlink (path.c_str (), target, sizeof (target));
+        if (len <= 0 || static_cast<std::size_t>(len) == sizeof (target))
+            break;
+
+        std::string const link (target, static_cast<std::size_t>(len));
+        if (link[0] == '/')
+            path = link;
+        else
+        {
+            // The first component of relative target is an entry in the
+            // same directory, e.g., `..data`.
+            names.push_back (link.substr (0, link.find ('/')));
+            path = dir + "/" + link;
+        }
+    }
+
+    return names;
+}
+
+
+//! Reads all pending events. Returns true if any of them concerns one of
+//! `names` or one of the watched directories themselves.
+bool
+drainInotifyEvents (int fd, std::vector<std::string> const & names)
+{
+    bool relevant = false;
+    alignas (inotify_event) char buffer[4096];
+    ssize_t len;
+    while ((len = ::read (fd, buffer, sizeof (buffer))) > 0)
+    {
+        for (char const * ptr = buffer; ptr < buffer + len; )
+        {
+            auto const * const ev = reinterpret_cast<inotify_event const *>(ptr);
+            ptr += sizeof (inotify_event) + ev->len;
+
+            if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED
+                    | IN_Q_OVERFLOW))
+                relevant = true;
+            else if (ev->len != 0
+                && std::find (names.begin (), names.end (), ev->name)
+                    != names.end ())
+                relevant = true;
+        }
+    }
+
+    return relevant;
+}
+
+} // namespace
+
+
+//! The watches are established before the thread starts, so that no
+//! change made after construction of ConfigureAndWatchThread is missed.
 void
-ConfigurationWatchDogThread::addAppender(Logger& logger,
-                                         SharedAppenderPtr& appender)
+ConfigurationWatchDogThread::initInotify()
 {
-    if(lock)
-        lock->addAppender(logger, appender);
-    else
-        PropertyConfigurator::addAppender(logger, appender);
+    inotifyFd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1)
+        return;
+
+    if (pipe2 (wakeUpPipe, O_CLOEXEC | O_NONBLOCK) == -1)
+    {
+        ::close (inotifyFd);
+        inotifyFd = wakeUpPipe[0] = wakeUpPipe[1] = -1;
+        return;
+    }
+
+    watchedNames = addInotifyWatches (inotifyFd,
+        LOG4CPLUS_TSTRING_TO_STRING (propertyFilename));
+}
+
+
+//! Waits for changes of the configuration file using inotify and
+//! reconfigures shortly after they settle down. Returns false if inotify
+//! cannot be used and the caller should fall back to polling.
+bool
+ConfigurationWatchDogThread::watchWithInotify()
+{
+    if (inotifyFd == -1)
+        return false;
+
+    pollfd fds[2] = { };
+    fds[0].fd = inotifyFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wakeUpPipe[0];
+    fds[1].events = POLLIN;
+
+    for (;;)
+    {
+        int ret = poll (fds, 2, -1);
+        if (ret == -1)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        if (fds[1].revents != 0)
+            return true;
+
+        bool relevant = drainInotifyEvents (inotifyFd, watchedNames);
+
+        // Coalesce bursts of events into single reconfiguration.
+        for (int round = 0; round != INOTIFY_MAX_COALESCE_ROUNDS; ++round)
+        {
+            ret = poll (fds, 2, INOTIFY_QUIET_MILLIS);
+            if (ret == 0)
+                break;
+            else if (ret == -1 && errno != EINTR)
+                return false;
+            else if (fds[1].revents != 0)
+                return true;
+
+            relevant = drainInotifyEvents (inotifyFd, watchedNames) || relevant;
+        }
+
+        if (! relevant)
+            continue;
+
+        // The file is re-read even if its modification time is unchanged;
+        // the granularity of mtime may be too coarse to notice a rewrite.
+        // Unchanged configuration is a no-op in reconfigureIncrementally().
+        helpers::FileInfo fi;
+        if (helpers::getFileInfo (&fi, propertyFilename) == 0)
+        {
+            reconfigureIncrementally ();
+            updateLastModInfo ();
+        }
+
+        // Links might point elsewhere now, re-establish the watches.
+        // inotify_add_watch() on already watched directory is harmless.
+        watchedNames = addInotifyWatches (inotifyFd,
+            LOG4CPLUS_TSTRING_TO_STRING (propertyFilename));
+    }
+}
+
+#endif // defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+
+
+namespace
+{
+
+//! Returns true if both `a` and `b` contain the same properties.
+bool
+equalProperties (helpers::Properties const & a, helpers::Properties const & b)
+{
+    if (a.size () != b.size ())
+        return false;
+
+    for (tstring const & name : a.propertyNames ())
+        if (! b.exists (name) || a.getProperty (name) != b.getProperty (name))
+            return false;
+
+    return true;
+}
+
+
+//! Returns names of appenders listed in logger configuration string.
+std::vector<tstring>
+loggerAppenderNames (tstring const & config)
+{
+    tstring configString;
+    std::remove_copy (config.begin (), config.end (),
+        std::back_inserter (configString), LOG4CPLUS_TEXT (' '));
+
+    std::vector<tstring> tokens;
+    helpers::tokenize (configString, LOG4CPLUS_TEXT (','),
+        std::back_inserter (tokens));
+    if (! tokens.empty ())
+        tokens.erase (tokens.begin ());
+
+    return tokens;
+}
+
+} // namespace
+
+
+//! Applies differences between the current and the modified
+//! configuration file. Levels and additivity are set in place, loggers
+//! and appenders whose configuration has not changed are not touched
+//! and only appenders whose configuration has changed are replaced. The
+//! hierarchy is not locked, logging continues meanwhile.
+void
+ConfigurationWatchDogThread::reconfigureIncrementally()
+{
+    helpers::Properties const oldProperties (std::move (properties));
+    properties = helpers::Properties (propertyFilename);
+    init ();
+    configureInternals ();
+
+    // Find the appenders created from the previous configuration.
+
+    helpers::Properties const oldAppenderProps
+        = oldProperties.getPropertySubset (LOG4CPLUS_TEXT ("appender."));
+    helpers::Properties const newAppenderProps
+        = properties.getPropertySubset (LOG4CPLUS_TEXT ("appender."));
+
+    LoggerList loggers = h.getCurrentLoggers ();
+    loggers.push_back (h.getRoot ());
+
+    AppenderMap previous;
+    for (Logger & logger : loggers)
+        for (SharedAppenderPtr & appender : logger.getAllAppenders ())
+        {
+            tstring const & name = appender->getName ();
+            if (oldAppenderProps.exists (name))
+                previous.emplace (name, appender);
+        }
+
+    // Keep appenders with unchanged configuration, create the others.
+
+    std::vector<tstring> replaced;
+    for (tstring const & name : newAppenderProps.propertyNames ())
+    {
+        if (name.find (LOG4CPLUS_TEXT ('.')) != tstring::npos)
+            continue;
+
+        tstring const prefix = name + LOG4CPLUS_TEXT (".");
+        auto const it = previous.find (name);
+        if (it != previous.end ()
+            && oldAppenderProps.getProperty (name)
+                == newAppenderProps.getProperty (name)
+            && equalProperties (oldAppenderProps.getPropertySubset (prefix),
+                newAppenderProps.getPropertySubset (prefix)))
+            appenders[name] = it->second;
+        else
+            configureAppender (name, newAppenderProps);
+    }
+
+    SharedAppenderPtrList stale;
+    for (auto const & kv : previous)
+    {
+        auto const it = appenders.find (kv.first);
+        if (it == appenders.end () || it->second != kv.second)
+        {
+            replaced.push_back (kv.first);
+            stale.push_back (kv.second);
+        }
+    }
+
+    auto referencesReplaced = [&replaced] (tstring const & config) {
+        for (tstring const & name : loggerAppenderNames (config))
+            if (std::find (replaced.begin (), replaced.end (), name)
+                != replaced.end ())
+                return true;
+        return false;
+    };
+
+    // Reconfigure loggers whose configuration or appenders have changed.
+    // Loggers removed from the configuration get default settings.
+
+    tstring const rootKey (LOG4CPLUS_TEXT ("rootLogger"));
+    if (properties.exists (rootKey))
+    {
+        tstring const & config = properties.getProperty (rootKey);
+        if (config != oldProperties.getProperty (rootKey)
+            || referencesReplaced (config))
+            configureLogger (h.getRoot (), config);
+    }
+    else if (oldProperties.exists (rootKey))
+    {
+        Logger root = h.getRoot ();
+        root.setLogLevel (DEBUG_LOG_LEVEL);
+        root.removeAllAppenders ();
+    }
+
+    helpers::Properties const oldLoggerProps
+        = oldProperties.getPropertySubset (LOG4CPLUS_TEXT ("logger."));
+    helpers::Properties const newLoggerProps
+        = properties.getPropertySubset (LOG4CPLUS_TEXT ("logger."));
+    for (tstring const & name : newLoggerProps.propertyNames ())
+    {
+        tstring const & config = newLoggerProps.getProperty (name);
+        if (! oldLoggerProps.exists (name)
+            || config != oldLoggerProps.getProperty (name)
+            || referencesReplaced (config))
+            configureLogger (getLogger (name), config);
+    }
+
+    for (tstring const & name : oldLoggerProps.propertyNames ())
+        if (! newLoggerProps.exists (name))
+        {
+            Logger logger = getLogger (name);
+            logger.setLogLevel (NOT_SET_LOG_LEVEL);
+            logger.removeAllAppenders ();
+        }
+
+    helpers::Properties const oldAdditivityProps
+        = oldProperties.getPropertySubset (LOG4CPLUS_TEXT ("additivity."));
+    helpers::Properties const newAdditivityProps
+        = properties.getPropertySubset (LOG4CPLUS_TEXT ("additivity."));
+    configureAdditivity ();
+    for (tstring const & name : oldAdditivityProps.propertyNames ())
+        if (! newAdditivityProps.exists (name))
+            getLogger (name).setAdditivity (true);
+
+    bool disable_override = false;
+    properties.getBool (disable_override, LOG4CPLUS_TEXT ("disableOverride"));
+    bool old_disable_override = false;
+    oldProperties.getBool (old_disable_override,
+        LOG4CPLUS_TEXT ("disableOverride"));
+    if (disable_override)
+        h.disable (Hierarchy::DISABLE_OVERRIDE);
+    else if (old_disable_override)
+        h.enableAll ();
+
+    // Detach replaced appenders from all loggers, also from those
+    // configured by other means, and close them.
+
+    for (SharedAppenderPtr const & appender : stale)
+    {
+        for (Logger & logger : loggers)
+            logger.removeAppender (appender);
+
+        appender->waitToFinishAsyncLogging ();
+        appender->close ();
+    }
+
+    appenders.clear ();
 }
 
 
@@ -650,6 +1301,217 @@ ConfigureAndWatchThread::~ConfigureAndWatchThread()
 }
 
 
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+namespace
+{
+
+//! Unique scratch directory, removed with its content on destruction.
+struct temp_dir
+{
+    temp_dir ()
+        : path (std::filesystem::temp_directory_path ()
+            / ("log4cplus-configurator-test-"
+                + std::to_string (internal::get_process_id ()) + "-"
+                + std::to_string (counter++)))
+    {
+        std::filesystem::remove_all (path);
+        std::filesystem::create_directory (path);
+    }
+
+    ~temp_dir ()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all (path, ec);
+    }
+
+    std::string file (char const * name) const
+    {
+        return (path / name).string ();
+    }
+
+    static inline unsigned counter = 0;
+    std::filesystem::path const path;
+};
+
+} // namespace
+
+
+CATCH_TEST_CASE ("Lazy appender activation", "[configurator]")
+{
+    temp_dir const tmp;
+    std::string const filename (tmp.file ("log4cplus-lazy-test.log"));
+
+    helpers::Properties props;
+    props.setProperty (LOG4CPLUS_TEXT ("log4cplus.appender.L"),
+        LOG4CPLUS_TEXT ("log4cplus::FileAppender"));
+    props.setProperty (LOG4CPLUS_TEXT ("log4cplus.appender.L.File"),
+        LOG4CPLUS_C_STR_TO_TSTRING (filename));
+    props.setProperty (LOG4CPLUS_TEXT ("log4cplus.appender.L.Activation"),
+        LOG4CPLUS_TEXT ("Lazy"));
+    props.setProperty (LOG4CPLUS_TEXT ("log4cplus.appender.L.Threshold"),
+        LOG4CPLUS_TEXT ("WARN"));
+    props.setProperty (LOG4CPLUS_TEXT ("log4cplus.appender.L.filters.1"),
+        LOG4CPLUS_TEXT ("log4cplus::spi::StringMatchFilter"));
+    props.setProperty (
+        LOG4CPLUS_TEXT ("log4cplus.appender.L.filters.1.StringToMatch"),
+        LOG4CPLUS_TEXT ("filtered"));
+    props.setProperty (
+        LOG4CPLUS_TEXT ("log4cplus.appender.L.filters.1.AcceptOnMatch"),
+        LOG4CPLUS_TEXT ("false"));
+    props.setProperty (LOG4CPLUS_TEXT ("log4cplus.logger.lazy"),
+        LOG4CPLUS_TEXT ("TRACE, L"));
+
+    Hierarchy h;
+    PropertyConfigurator (props, h).configure ();
+    Logger logger = h.getInstance (LOG4CPLUS_TEXT ("lazy"));
+    SharedAppenderPtr const appender
+        = logger.getAppender (LOG4CPLUS_TEXT ("L"));
+    CATCH_REQUIRE (appender);
+    CATCH_REQUIRE (appender->getName () == LOG4CPLUS_TEXT ("L"));
+
+    auto fileExists = [&] {
+        helpers::FileInfo fi;
+        return helpers::getFileInfo (&fi,
+            LOG4CPLUS_C_STR_TO_TSTRING (filename)) == 0;
+    };
+
+    // Nothing is opened until an event passes the threshold and filters.
+    CATCH_REQUIRE (! fileExists ());
+    logger.log (INFO_LOG_LEVEL, LOG4CPLUS_TEXT ("below threshold"));
+    CATCH_REQUIRE (! fileExists ());
+    logger.log (WARN_LOG_LEVEL, LOG4CPLUS_TEXT ("filtered out"));
+    CATCH_REQUIRE (! fileExists ());
+    CATCH_REQUIRE (appender->getEventFields () == spi::EVENT_FIELDS_ALL);
+
+    logger.log (WARN_LOG_LEVEL, LOG4CPLUS_TEXT ("activates"));
+    CATCH_REQUIRE (fileExists ());
+    CATCH_REQUIRE (appender->getEventFields () != spi::EVENT_FIELDS_ALL);
+
+    // The logger holds the stand-in, the real appender is behind it.
+    CATCH_REQUIRE (! dynamic_cast<FileAppender *> (appender.get ()));
+    SharedAppenderPtr const real
+        = PropertyConfigurator::getActivatedAppender (appender);
+    CATCH_REQUIRE (dynamic_cast<FileAppender *> (real.get ()));
+    CATCH_REQUIRE (real->getName () == LOG4CPLUS_TEXT ("L"));
+
+    h.shutdown ();
+    CATCH_REQUIRE (appender->isClosed ());
+    {
+        std::ifstream file (filename.c_str ());
+        std::string line;
+        CATCH_REQUIRE (std::getline (file, line));
+        CATCH_REQUIRE (line.find ("activates") != std::string::npos);
+        CATCH_REQUIRE (! std::getline (file, line));
+    }
+}
+
+
+CATCH_TEST_CASE ("ConfigureAndWatchThread", "[configurator]")
+{
+    CATCH_SECTION ("incremental reconfiguration")
+    {
+        temp_dir const tmp;
+        std::string const filename (tmp.file ("log4cplus.properties"));
+        auto writeConfig = [&] (tstring const & config) {
+            tofstream file (filename.c_str (), std::ios_base::trunc);
+            file << config;
+        };
+
+        writeConfig (
+            LOG4CPLUS_TEXT ("log4cplus.appender.A=log4cplus::ConsoleAppender\n")
+            LOG4CPLUS_TEXT ("log4cplus.appender.B=log4cplus::ConsoleAppender\n")
+            LOG4CPLUS_TEXT ("log4cplus.logger.watch.a=INFO, A\n")
+            LOG4CPLUS_TEXT ("log4cplus.logger.watch.b=INFO, B\n"));
+
+        Logger a = Logger::getInstance (LOG4CPLUS_TEXT ("watch.a"));
+        Logger b = Logger::getInstance (LOG4CPLUS_TEXT ("watch.b"));
+        {
+            ConfigureAndWatchThread const watch (
+                LOG4CPLUS_C_STR_TO_TSTRING (filename), 1000);
+            CATCH_REQUIRE (a.getLogLevel () == INFO_LOG_LEVEL);
+            SharedAppenderPtr const appenderA
+                = a.getAppender (LOG4CPLUS_TEXT ("A"));
+            SharedAppenderPtr const appenderB
+                = b.getAppender (LOG4CPLUS_TEXT ("B"));
+            CATCH_REQUIRE (appenderA);
+            CATCH_REQUIRE (appenderB);
+
+            // Change level of one logger and options of the other
+            // logger's appender.
+            writeConfig (
+                LOG4CPLUS_TEXT ("log4cplus.appender.A=log4cplus::ConsoleAppender\n")
+                LOG4CPLUS_TEXT ("log4cplus.appender.B=log4cplus::ConsoleAppender\n")
+                LOG4CPLUS_TEXT ("log4cplus.appender.B.Threshold=ERROR\n")
+                LOG4CPLUS_TEXT ("log4cplus.logger.watch.a=ERROR, A\n")
+                LOG4CPLUS_TEXT ("log4cplus.logger.watch.b=INFO, B\n"));
+
+            for (int i = 0; i != 100 && a.getLogLevel () != ERROR_LOG_LEVEL;
+                ++i)
+                std::this_thread::sleep_for (std::chrono::milliseconds (100));
+
+            CATCH_REQUIRE (a.getLogLevel () == ERROR_LOG_LEVEL);
+            CATCH_REQUIRE (a.getAppender (LOG4CPLUS_TEXT ("A")) == appenderA);
+            CATCH_REQUIRE (! appenderA->isClosed ());
+
+            SharedAppenderPtr const newAppenderB
+                = b.getAppender (LOG4CPLUS_TEXT ("B"));
+            CATCH_REQUIRE (newAppenderB);
+            CATCH_REQUIRE (newAppenderB != appenderB);
+            CATCH_REQUIRE (newAppenderB->getThreshold () == ERROR_LOG_LEVEL);
+            CATCH_REQUIRE (appenderB->isClosed ());
+        }
+
+        a.removeAllAppenders ();
+        b.removeAllAppenders ();
+    }
+
+#if defined (LOG4CPLUS_WATCH_WITH_INOTIFY)
+    CATCH_SECTION ("symbolic link swap")
+    {
+        // Mimic layout of Kubernetes ConfigMap volume: the configuration
+        // file links through `..data` to a timestamped directory and the
+        // update swaps the `..data` link atomically.
+        temp_dir const tmp;
+        std::string const dir (tmp.path.string ());
+        std::string const filename (dir + "/log4cplus.properties");
+        auto writeConfig = [&] (std::string const & data,
+            tstring const & config) {
+            mkdir ((dir + "/" + data).c_str (), 0755);
+            tofstream file ((dir + "/" + data + "/log4cplus.properties").c_str (),
+                std::ios_base::trunc);
+            file << config;
+        };
+
+        writeConfig ("..1", LOG4CPLUS_TEXT ("log4cplus.logger.watch.c=INFO\n"));
+        CATCH_REQUIRE (symlink ("..1", (dir + "/..data").c_str ()) == 0);
+        CATCH_REQUIRE (symlink ("..data/log4cplus.properties",
+                filename.c_str ()) == 0);
+
+        Logger c = Logger::getInstance (LOG4CPLUS_TEXT ("watch.c"));
+        {
+            // Polling interval is long enough for the test to show that
+            // the change has been noticed by inotify.
+            ConfigureAndWatchThread const watch (
+                LOG4CPLUS_C_STR_TO_TSTRING (filename), 3600 * 1000);
+            CATCH_REQUIRE (c.getLogLevel () == INFO_LOG_LEVEL);
+
+            writeConfig ("..2", LOG4CPLUS_TEXT ("log4cplus.logger.watch.c=WARN\n"));
+            CATCH_REQUIRE (symlink ("..2", (dir + "/..data_tmp").c_str ()) == 0);
+            CATCH_REQUIRE (std::rename ((dir + "/..data_tmp").c_str (),
+                    (dir + "/..data").c_str ()) == 0);
+
+            for (int i = 0; i != 100 && c.getLogLevel () != WARN_LOG_LEVEL;
+                ++i)
+                std::this_thread::sleep_for (std::chrono::milliseconds (50));
+
+            CATCH_REQUIRE (c.getLogLevel () == WARN_LOG_LEVEL);
+        }
+    }
+#endif
+}
+#endif // LOG4CPLUS_WITH_UNIT_TESTS
+
+
 #endif
 
 
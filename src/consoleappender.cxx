@@ -102,6 +102,13 @@ ConsoleAppender::close()
 }
 
 
+unsigned
+ConsoleAppender::getEventFields() const
+{
+    return getLayoutEventFields ();
+}
+
+
 
 //////////////////////////////////////////////////////////////////////////////
 // ConsoleAppender protected methods
@@ -119,7 +126,7 @@ ConsoleAppender::append(const spi::InternalLoggingEvent& event)
         cur_loc = output.getloc();
         output.imbue(*locale);
     }
-    layout->formatAndAppend(output, event);
+    formatAndAppend(output, event);
     if(immediateFlush) {
         output.flush();
     }
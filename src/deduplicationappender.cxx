@@ -0,0 +1,506 @@
+// -*- C++ -*-
+//  Copyright (C) 2026, log4cplus contributors. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <log4cplus/deduplicationappender.h>
+#include <log4cplus/spi/factory.h>
+#include <log4cplus/spi/loggingevent.h>
+#include <log4cplus/helpers/loglog.h>
+#include <log4cplus/helpers/property.h>
+#include <log4cplus/helpers/stringhelper.h>
+#include <log4cplus/helpers/timehelper.h>
+#include <log4cplus/thread/syncprims-pub-impl.h>
+#include <log4cplus/thread/threads.h>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <log4cplus/callbackappender.h>
+#include <vector>
+#include <thread>
+#include <catch_amalgamated.hpp>
+#endif
+
+
+namespace log4cplus
+{
+
+
+//! Open windows are kept in a list ordered by their start, so that
+//! expired windows and the oldest window are always at its front. The
+//! index maps fingerprint hashes to list entries.
+struct DeduplicationAppender::State
+{
+    using Clock = std::chrono::steady_clock;
+
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    //! Closes windows as they expire so that summaries are not held
+    //! back until the next event or close(). It sleeps without timeout
+    //! while no window is open.
+    class Timer
+        : public thread::AbstractThread
+    {
+    public:
+        explicit Timer (DeduplicationAppender & app_)
+            : app (app_)
+        { }
+
+        void run () override;
+
+        //! Makes the timer fire no later than at `at`.
+        void arm (Clock::time_point at);
+
+        void terminate ();
+
+    private:
+        DeduplicationAppender & app;
+        std::mutex mtx;
+        std::condition_variable cv;
+        //! Clock::time_point::max () while the timer is not armed.
+        Clock::time_point deadline = Clock::time_point::max ();
+        bool terminating = false;
+    };
+#endif
+
+    struct Entry
+    {
+        std::size_t hash;
+        Clock::time_point expiry;
+        std::size_t repeats;
+        spi::InternalLoggingEvent event;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    State (Clock::duration window_, Key key_, unsigned maxEntries_)
+        : window (window_)
+        , key (key_)
+        , maxEntries ((std::max) (maxEntries_, 1u))
+    { }
+
+    std::size_t hash (spi::InternalLoggingEvent const & ev) const;
+    bool equal (spi::InternalLoggingEvent const & a,
+        spi::InternalLoggingEvent const & b) const;
+    EntryList::iterator find (spi::InternalLoggingEvent const & ev,
+        std::size_t h);
+    void closeWindow (EntryList::iterator it,
+        helpers::AppenderAttachableImpl const & appenders);
+    void closeExpiredWindows (Clock::time_point now,
+        helpers::AppenderAttachableImpl const & appenders);
+
+    Clock::duration const window;
+    Key const key;
+    std::size_t const maxEntries;
+    EntryList entries;
+    std::unordered_multimap<std::size_t, EntryList::iterator> index;
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    helpers::SharedObjectPtr<Timer> timer;
+#endif
+};
+
+
+std::size_t
+DeduplicationAppender::State::hash (spi::InternalLoggingEvent const & ev)
+    const
+{
+    // Logger names are interned, equal names share storage.
+    std::size_t h = std::hash<void const *> () (
+        ev.getLoggerNameHandle ().get ());
+    auto combine = [&h] (std::size_t v) {
+        h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+    };
+
+    combine (static_cast<std::size_t> (ev.getLogLevel ()));
+    if (key == Key::CALL_SITE)
+    {
+        combine (std::hash<tstring> () (ev.getFile ()));
+        combine (static_cast<std::size_t> (ev.getLine ()));
+    }
+    else
+        combine (std::hash<tstring> () (ev.getMessage ()));
+
+    return h;
+}
+
+
+bool
+DeduplicationAppender::State::equal (spi::InternalLoggingEvent const & a,
+    spi::InternalLoggingEvent const & b) const
+{
+    if (a.getLoggerNameHandle () != b.getLoggerNameHandle ()
+        || a.getLogLevel () != b.getLogLevel ())
+        return false;
+    else if (key == Key::CALL_SITE)
+        return a.getLine () == b.getLine () && a.getFile () == b.getFile ();
+    else
+        return a.getMessage () == b.getMessage ();
+}
+
+
+DeduplicationAppender::State::EntryList::iterator
+DeduplicationAppender::State::find (spi::InternalLoggingEvent const & ev,
+    std::size_t h)
+{
+    auto const range = index.equal_range (h);
+    for (auto it = range.first; it != range.second; ++it)
+        if (equal (it->second->event, ev))
+            return it->second;
+
+    return entries.end ();
+}
+
+
+void
+DeduplicationAppender::State::closeWindow (EntryList::iterator it,
+    helpers::AppenderAttachableImpl const & appenders)
+{
+    auto const range = index.equal_range (it->hash);
+    for (auto idx = range.first; idx != range.second; ++idx)
+        if (idx->second == it)
+        {
+            index.erase (idx);
+            break;
+        }
+
+    // Unlink the entry before appending the summary so that the summary
+    // is appended with consistent state if it gets back here.
+    Entry entry (std::move (*it));
+    entries.erase (it);
+
+    if (entry.repeats == 0)
+        return;
+
+    spi::InternalLoggingEvent const & ev = entry.event;
+    tstring message = LOG4CPLUS_TEXT ("Message repeated ")
+        + helpers::convertIntegerToString (entry.repeats)
+        + (key == Key::CALL_SITE
+            ? LOG4CPLUS_TEXT (" times from this call site, first: ")
+            : LOG4CPLUS_TEXT (" times: "))
+        + ev.getMessage ();
+    spi::InternalLoggingEvent const summary (ev.getLoggerName (),
+        ev.getLogLevel (), ev.getNDC (), ev.getMDCCopy (), message,
+        ev.getThread (), ev.getThread2 (), helpers::now (), ev.getFile (),
+        ev.getLine (), ev.getFunction ());
+    appenders.appendLoopOnAppenders (summary);
+}
+
+
+void
+DeduplicationAppender::State::closeExpiredWindows (Clock::time_point now,
+    helpers::AppenderAttachableImpl const & appenders)
+{
+    while (! entries.empty () && entries.front ().expiry <= now)
+        closeWindow (entries.begin (), appenders);
+}
+
+
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+void
+DeduplicationAppender::State::Timer::arm (Clock::time_point at)
+{
+    std::lock_guard guard (mtx);
+    if (at < deadline)
+    {
+        deadline = at;
+        cv.notify_one ();
+    }
+}
+
+
+void
+DeduplicationAppender::State::Timer::terminate ()
+{
+    {
+        std::lock_guard guard (mtx);
+        terminating = true;
+    }
+    cv.notify_one ();
+    join ();
+}
+
+
+void
+DeduplicationAppender::State::Timer::run ()
+{
+    // Lock order is access_mutex, then mtx, as in append(). This thread
+    // never takes access_mutex while it holds mtx.
+    std::unique_lock lock (mtx);
+    while (! terminating)
+    {
+        if (deadline == Clock::time_point::max ())
+            cv.wait (lock);
+        else if (Clock::now () < deadline)
+            cv.wait_until (lock, deadline);
+        else
+        {
+            deadline = Clock::time_point::max ();
+            lock.unlock ();
+            {
+                thread::MutexGuard guard (app.access_mutex);
+                State & st = *app.state;
+                st.closeExpiredWindows (Clock::now (), app);
+                if (! st.entries.empty ())
+                    arm (st.entries.front ().expiry);
+            }
+            lock.lock ();
+        }
+    }
+}
+#endif
+
+
+//
+//
+//
+
+DeduplicationAppender::DeduplicationAppender (SharedAppenderPtr const & app,
+    std::chrono::steady_clock::duration window, Key key, unsigned maxEntries)
+{
+    addAppender (app);
+    init (window, key, maxEntries);
+    init_timer_thread ();
+}
+
+
+DeduplicationAppender::DeduplicationAppender (
+    helpers::Properties const & props)
+    : Appender (props)
+{
+    unsigned window = 10;
+    props.getUInt (window, LOG4CPLUS_TEXT ("Window"));
+    unsigned maxEntries = 1024;
+    props.getUInt (maxEntries, LOG4CPLUS_TEXT ("MaxEntries"));
+
+    Key key = Key::MESSAGE;
+    tstring const keyName = helpers::toLower (
+        props.getProperty (LOG4CPLUS_TEXT ("Key")));
+    if (keyName == LOG4CPLUS_TEXT ("callsite"))
+        key = Key::CALL_SITE;
+    else if (! keyName.empty () && keyName != LOG4CPLUS_TEXT ("message"))
+        helpers::getLogLog ().error (
+            LOG4CPLUS_TEXT ("DeduplicationAppender- unknown Key: ")
+            + keyName);
+
+    init (std::chrono::seconds (window), key, maxEntries);
+
+    tstring const & appender_name (
+        props.getProperty (LOG4CPLUS_TEXT ("Appender")));
+    if (appender_name.empty ())
+    {
+        getErrorHandler ()->error (
+            LOG4CPLUS_TEXT ("Unspecified appender for DeduplicationAppender."));
+        return;
+    }
+
+    spi::AppenderFactoryRegistry & appender_registry
+        = spi::getAppenderFactoryRegistry ();
+    spi::AppenderFactory * factory = appender_registry.get (appender_name);
+    if (! factory)
+    {
+        helpers::getLogLog ().error (
+            LOG4CPLUS_TEXT ("DeduplicationAppender::DeduplicationAppender()")
+            LOG4CPLUS_TEXT (" - Cannot find AppenderFactory: ")
+            + appender_name, true);
+        std::unreachable ();
+    }
+
+    helpers::Properties appender_props = props.getPropertySubset (
+        LOG4CPLUS_TEXT ("Appender."));
+    addAppender (factory->createObject (appender_props));
+    init_timer_thread ();
+}
+
+
+DeduplicationAppender::~DeduplicationAppender ()
+{
+    destructorImpl ();
+}
+
+
+void
+DeduplicationAppender::init (std::chrono::steady_clock::duration window,
+    Key key, unsigned maxEntries)
+{
+    state = std::make_unique<State> (window, key, maxEntries);
+}
+
+
+void
+DeduplicationAppender::init_timer_thread ()
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    state->timer = new State::Timer (*this);
+    state->timer->start ();
+#endif
+}
+
+
+void
+DeduplicationAppender::close ()
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    // The timer takes access_mutex, stop it before taking it here.
+    if (state->timer)
+    {
+        state->timer->terminate ();
+        state->timer = nullptr;
+    }
+#endif
+
+    {
+        thread::MutexGuard guard (access_mutex);
+        while (! state->entries.empty ())
+            state->closeWindow (state->entries.begin (), *this);
+    }
+
+    removeAllAppenders ();
+}
+
+
+void
+DeduplicationAppender::append (spi::InternalLoggingEvent const & ev)
+{
+    State & st = *state;
+    State::Clock::time_point const now = State::Clock::now ();
+    st.closeExpiredWindows (now, *this);
+
+    std::size_t const h = st.hash (ev);
+    if (auto it = st.find (ev, h); it != st.entries.end ())
+    {
+        ++it->repeats;
+        return;
+    }
+
+    if (st.entries.size () >= st.maxEntries)
+        st.closeWindow (st.entries.begin (), *this);
+
+    st.entries.push_back (State::Entry {h, now + st.window, 0,
+        spi::InternalLoggingEvent (ev, spi::EVENT_FIELDS_ALL)});
+    st.index.emplace (h, std::prev (st.entries.end ()));
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    if (st.timer)
+        st.timer->arm (st.entries.back ().expiry);
+#endif
+
+    appendLoopOnAppenders (ev);
+}
+
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+CATCH_TEST_CASE ("DeduplicationAppender", "[appender]")
+{
+    std::vector<tstring> messages;
+    SharedAppenderPtr const sink (new CallbackAppender (
+        [] (void * cookie, log4cplus_char_t const * message,
+            log4cplus_char_t const *, log4cplus_loglevel_t,
+            log4cplus_char_t const *, log4cplus_char_t const *,
+            unsigned long long, unsigned long, log4cplus_char_t const *,
+            log4cplus_char_t const *, int) {
+            static_cast<std::vector<tstring> *> (cookie)->push_back (message);
+        }, &messages));
+    tstring const logger = LOG4CPLUS_TEXT ("test");
+
+    CATCH_SECTION ("repeats are collapsed")
+    {
+        SharedAppenderPtr app (new DeduplicationAppender (sink,
+            std::chrono::hours (1)));
+        for (int i = 0; i != 5; ++i)
+            app->doAppend (spi::InternalLoggingEvent (logger, ERROR_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("disk full"), __FILE__, __LINE__));
+        app->doAppend (spi::InternalLoggingEvent (logger, WARN_LOG_LEVEL,
+            LOG4CPLUS_TEXT ("disk full"), __FILE__, __LINE__));
+        CATCH_REQUIRE (messages.size () == 2);
+
+        app->close ();
+        CATCH_REQUIRE (messages == std::vector<tstring> {
+            LOG4CPLUS_TEXT ("disk full"), LOG4CPLUS_TEXT ("disk full"),
+            LOG4CPLUS_TEXT ("Message repeated 4 times: disk full")});
+    }
+
+    CATCH_SECTION ("oldest window is closed at the limit")
+    {
+        SharedAppenderPtr app (new DeduplicationAppender (sink,
+            std::chrono::hours (1), DeduplicationAppender::Key::CALL_SITE, 1));
+        for (int i = 0; i != 3; ++i)
+            app->doAppend (spi::InternalLoggingEvent (logger, ERROR_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("error ") + helpers::convertIntegerToString (i),
+                "a.cxx", 1));
+        app->doAppend (spi::InternalLoggingEvent (logger, ERROR_LOG_LEVEL,
+            LOG4CPLUS_TEXT ("other"), "b.cxx", 1));
+        CATCH_REQUIRE (messages == std::vector<tstring> {
+            LOG4CPLUS_TEXT ("error 0"),
+            LOG4CPLUS_TEXT (
+                "Message repeated 2 times from this call site, first: error 0"),
+            LOG4CPLUS_TEXT ("other")});
+        app->close ();
+        CATCH_REQUIRE (messages.size () == 3);
+    }
+
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    CATCH_SECTION ("expired windows are closed without further events")
+    {
+        struct
+        {
+            std::mutex mtx;
+            std::vector<tstring> messages;
+        } sink_state;
+        SharedAppenderPtr const locked_sink (new CallbackAppender (
+            [] (void * cookie, log4cplus_char_t const * message,
+                log4cplus_char_t const *, log4cplus_loglevel_t,
+                log4cplus_char_t const *, log4cplus_char_t const *,
+                unsigned long long, unsigned long, log4cplus_char_t const *,
+                log4cplus_char_t const *, int) {
+                auto & st = *static_cast<decltype (sink_state) *> (cookie);
+                std::lock_guard guard (st.mtx);
+                st.messages.push_back (message);
+            }, &sink_state));
+        SharedAppenderPtr app (new DeduplicationAppender (locked_sink,
+            std::chrono::milliseconds (20)));
+        for (int i = 0; i != 3; ++i)
+            app->doAppend (spi::InternalLoggingEvent (logger, ERROR_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("disk full"), __FILE__, __LINE__));
+
+        auto const summarized = [&sink_state] {
+            std::lock_guard guard (sink_state.mtx);
+            return sink_state.messages.size () == 2;
+        };
+        for (int i = 0; i != 500 && ! summarized (); ++i)
+            std::this_thread::sleep_for (std::chrono::milliseconds (10));
+
+        CATCH_REQUIRE (summarized ());
+        CATCH_REQUIRE (sink_state.messages.back ()
+            == LOG4CPLUS_TEXT ("Message repeated 2 times: disk full"));
+        app->close ();
+        CATCH_REQUIRE (sink_state.messages.size () == 2);
+    }
+#endif
+}
+#endif // LOG4CPLUS_WITH_UNIT_TESTS
+
+
+} // namespace log4cplus
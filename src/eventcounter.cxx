@@ -75,8 +75,9 @@ SteadyClockGate::latch_open (SteadyClockGate::Info & info)
     auto const now = Clock::now ();
     if (now >= timeout_point
         // Has anything changed since the first check
-        // at the start of the function?
-        && (count = event_count.load ()) > 0)
+        // at the start of the function? Start counting events
+        // of the next time span.
+        && (count = event_count.exchange (0)) > 0)
     {
         info.count = count;
         info.time_span = now - prev_timeout_point;
@@ -25,6 +25,7 @@
 #include <log4cplus/helpers/property.h>
 #include <log4cplus/asyncappender.h>
 #include <log4cplus/consoleappender.h>
+#include <log4cplus/deduplicationappender.h>
 #include <log4cplus/fileappender.h>
 #include <log4cplus/nteventlogappender.h>
 #include <log4cplus/nullappender.h>
@@ -182,6 +183,7 @@ void initializeFactoryRegistry()
     LOG4CPLUS_REG_APPENDER (reg, AsyncAppender);
 #endif
     LOG4CPLUS_REG_APPENDER (reg, Log4jUdpAppender);
+    LOG4CPLUS_REG_APPENDER (reg, DeduplicationAppender);
 
     spi::LayoutFactoryRegistry& reg2 = spi::getLayoutFactoryRegistry();
     DisableFactoryLocking<spi::LayoutFactoryRegistry> dfl_reg2 (reg2);
@@ -195,6 +197,9 @@ void initializeFactoryRegistry()
     LOG4CPLUS_REG_FILTER (reg3, LogLevelMatchFilter);
     LOG4CPLUS_REG_FILTER (reg3, LogLevelRangeFilter);
     LOG4CPLUS_REG_FILTER (reg3, StringMatchFilter);
+    LOG4CPLUS_REG_FILTER (reg3, MultiStringMatchFilter);
+    LOG4CPLUS_REG_FILTER (reg3, RateLimitFilter);
+    LOG4CPLUS_REG_FILTER (reg3, SamplingFilter);
     LOG4CPLUS_REG_FILTER (reg3, NDCMatchFilter);
     LOG4CPLUS_REG_FILTER (reg3, MDCMatchFilter);
 
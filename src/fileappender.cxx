@@ -312,6 +312,13 @@ FileAppenderBase::getloc () const
 }
 
 
+unsigned
+FileAppenderBase::getEventFields() const
+{
+    return getLayoutEventFields ();
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // FileAppenderBase protected methods
 ///////////////////////////////////////////////////////////////////////////////
@@ -336,7 +343,7 @@ FileAppenderBase::append(const spi::InternalLoggingEvent& event)
     if (useLockFile)
         out.seekp (0, std::ios_base::end);
 
-    layout->formatAndAppend(out, event);
+    formatAndAppend(out, event);
 
     if(immediateFlush || useLockFile)
         out.flush();
@@ -746,6 +753,14 @@ DailyRollingFileAppender::close()
 }
 
 
+unsigned
+DailyRollingFileAppender::getEventFields() const
+{
+    // Rollover is driven by time stamps of events.
+    return getLayoutEventFields () | spi::EVENT_FIELD_TIMESTAMP;
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // DailyRollingFileAppender protected methods
@@ -1376,6 +1391,14 @@ TimeBasedRollingFileAppender::close()
     FileAppenderBase::close();
 }
 
+
+unsigned
+TimeBasedRollingFileAppender::getEventFields() const
+{
+    // Rollover is driven by time stamps of events.
+    return getLayoutEventFields () | spi::EVENT_FIELD_TIMESTAMP;
+}
+
 void
 TimeBasedRollingFileAppender::rollover(bool alreadyLocked)
 {
@@ -1484,6 +1507,119 @@ TimeBasedRollingFileAppender::calculateNextRolloverTime(const Time& t) const
 
 
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+namespace
+{
+
+//! Writes every number it is given through the stream, so that the
+//! output shows which locale it has been formatted with.
+class NumberLayout
+    : public Layout
+{
+public:
+    void formatAndAppend (tostream & output,
+        spi::InternalLoggingEvent const & event) override
+    {
+        output << event.getLine () << LOG4CPLUS_TEXT ("\n");
+    }
+};
+
+
+struct thousands_numpunct
+    : std::numpunct<tchar>
+{
+    tchar do_thousands_sep () const override { return LOG4CPLUS_TEXT ('\''); }
+    std::string do_grouping () const override { return "\3"; }
+};
+
+
+//! Unique scratch directory, removed with its content on destruction.
+struct temp_dir
+{
+    temp_dir ()
+        : path (std::filesystem::temp_directory_path ()
+            / ("log4cplus-fileappender-test-"
+                + std::to_string (internal::get_process_id ())))
+    {
+        std::filesystem::remove_all (path);
+        std::filesystem::create_directory (path);
+    }
+
+    ~temp_dir ()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all (path, ec);
+    }
+
+    tstring file (char const * name) const
+    {
+        return LOG4CPLUS_STRING_TO_TSTRING ((path / name).string ());
+    }
+
+    std::filesystem::path const path;
+};
+
+} // namespace
+
+
+CATCH_TEST_CASE ("FileAppender", "[appender]")
+{
+    temp_dir const dir;
+
+    CATCH_SECTION ("concurrent formatting")
+    {
+        tstring const filename
+            = dir.file ("log4cplus-concurrent-formatting.log");
+        {
+            SharedAppenderPtr app (new FileAppender (filename,
+                std::ios_base::trunc));
+            app->setLayout (std::make_unique<SimpleLayout> ());
+            app->setConcurrentFormatting (true);
+            app->addFilter ([] (spi::InternalLoggingEvent const & ev) {
+                return ev.getLogLevel () == DEBUG_LOG_LEVEL
+                    ? spi::FilterResult::DENY
+                    : spi::FilterResult::NEUTRAL; });
+
+            tstring const logger = LOG4CPLUS_TEXT ("test");
+            app->doAppend (spi::InternalLoggingEvent (logger, DEBUG_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("denied"), __FILE__, __LINE__));
+            app->doAppend (spi::InternalLoggingEvent (logger, INFO_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("passed"), __FILE__, __LINE__));
+            app->close ();
+        }
+
+        tifstream file (LOG4CPLUS_TSTRING_TO_STRING (filename).c_str ());
+        tstring line;
+        CATCH_REQUIRE (std::getline (file, line));
+        CATCH_REQUIRE (line == LOG4CPLUS_TEXT ("INFO - passed"));
+        CATCH_REQUIRE (! std::getline (file, line));
+    }
+
+    CATCH_SECTION ("concurrent formatting keeps imbued locale")
+    {
+        tstring const filename = dir.file ("log4cplus-imbued-locale.log");
+        {
+            FileAppender * const file_app = new FileAppender (filename,
+                std::ios_base::trunc);
+            SharedAppenderPtr app (file_app);
+            app->setLayout (std::make_unique<NumberLayout> ());
+            app->setConcurrentFormatting (true);
+            file_app->imbue (std::locale (std::locale::classic (),
+                new thousands_numpunct));
+
+            app->doAppend (spi::InternalLoggingEvent (LOG4CPLUS_TEXT ("test"),
+                INFO_LOG_LEVEL, LOG4CPLUS_TEXT ("message"), __FILE__,
+                1234567));
+            app->close ();
+        }
+
+        tifstream file (LOG4CPLUS_TSTRING_TO_STRING (filename).c_str ());
+        tstring line;
+        CATCH_REQUIRE (std::getline (file, line));
+        CATCH_REQUIRE (line == LOG4CPLUS_TEXT ("1'234'567"));
+    }
+}
+
+
 CATCH_TEST_CASE ("TimeBasedRollingFileAppender", "[appender]")
 {
 
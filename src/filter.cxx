@@ -22,8 +22,21 @@
 #include <log4cplus/helpers/loglog.h>
 #include <log4cplus/helpers/stringhelper.h>
 #include <log4cplus/helpers/property.h>
+#include <log4cplus/helpers/eventcounter.h>
 #include <log4cplus/spi/loggingevent.h>
 #include <log4cplus/thread/syncprims-pub-impl.h>
+#include <log4cplus/fstreams.h>
+#include <log4cplus/streams.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
 
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
 #include <log4cplus/logger.h>
@@ -56,6 +69,17 @@ checkFilter(const Filter* filter, const InternalLoggingEvent& event)
 }
 
 
+unsigned
+getFilterEventFields(const Filter* filter)
+{
+    unsigned fields = EVENT_FIELDS_NONE;
+    for (const Filter* f = filter; f; f = f->next.get())
+        fields |= f->getEventFields();
+
+    return fields;
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // Filter implementation
@@ -67,6 +91,20 @@ Filter::Filter() = default;
 Filter::~Filter() = default;
 
 
+unsigned
+Filter::getEventFields() const
+{
+    return EVENT_FIELDS_ALL;
+}
+
+
+bool
+Filter::getLevelBreakpoints(std::vector<LogLevel>&) const
+{
+    return false;
+}
+
+
 void
 Filter::appendFilter(FilterPtr filter)
 {
@@ -78,6 +116,119 @@ Filter::appendFilter(FilterPtr filter)
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// CompiledFilterChain implementation
+///////////////////////////////////////////////////////////////////////////////
+
+CompiledFilterChain::CompiledFilterChain()
+    : CompiledFilterChain (FilterPtr ())
+{ }
+
+
+CompiledFilterChain::CompiledFilterChain(FilterPtr head_)
+    : head (std::move (head_))
+{
+    std::vector<Filter const *> levelFilters;
+    bool leadingDone = false;
+    auto flushLevelFilters = [&] {
+        if (! leadingDone)
+            leading = compileLevels (levelFilters);
+        else if (! levelFilters.empty ())
+            steps.push_back (Step {compileLevels (levelFilters), nullptr});
+        levelFilters.clear ();
+        leadingDone = true;
+    };
+
+    std::vector<LogLevel> breakpoints;
+    for (Filter const * f = head.get (); f; f = f->next.get ())
+    {
+        if (f->getLevelBreakpoints (breakpoints))
+            levelFilters.push_back (f);
+        else
+        {
+            flushLevelFilters ();
+            steps.push_back (Step {LevelTable (), f});
+        }
+    }
+    flushLevelFilters ();
+
+    // Without dynamic steps the leading table decides every event, the
+    // end of the chain accepts.
+    if (steps.empty ())
+        std::replace (leading.result.begin (), leading.result.end (),
+            FilterResult::NEUTRAL, FilterResult::ACCEPT);
+}
+
+
+CompiledFilterChain::~CompiledFilterChain() = default;
+
+
+CompiledFilterChain::LevelTable
+CompiledFilterChain::compileLevels(std::vector<Filter const *> const & filters)
+{
+    std::vector<LogLevel> breakpoints {(std::numeric_limits<LogLevel>::min) ()};
+    for (Filter const * f : filters)
+        f->getLevelBreakpoints (breakpoints);
+    std::sort (breakpoints.begin (), breakpoints.end ());
+    breakpoints.erase (std::unique (breakpoints.begin (), breakpoints.end ()),
+        breakpoints.end ());
+
+    // The filters read only the log level, so the decision at each
+    // breakpoint is that for an event of the breakpoint's level.
+    LevelTable table;
+    for (LogLevel const ll : breakpoints)
+    {
+        InternalLoggingEvent const probe (tstring_view (), ll, tstring_view (),
+            nullptr, 0);
+        FilterResult result = FilterResult::NEUTRAL;
+        for (Filter const * f : filters)
+            if ((result = f->decide (probe)) != FilterResult::NEUTRAL)
+                break;
+
+        if (table.result.empty () || table.result.back () != result)
+        {
+            table.from.push_back (ll);
+            table.result.push_back (result);
+        }
+    }
+
+    return table;
+}
+
+
+FilterResult
+CompiledFilterChain::LevelTable::lookup(LogLevel ll) const
+{
+    if (from.size () == 1)
+        return result.front ();
+
+    auto const it = std::upper_bound (from.begin (), from.end (), ll);
+    return result[it - from.begin () - 1];
+}
+
+
+FilterResult
+CompiledFilterChain::check(const InternalLoggingEvent& event) const
+{
+    LogLevel const ll = event.getLogLevel ();
+    FilterResult result = leading.lookup (ll);
+    if (result != FilterResult::NEUTRAL || steps.empty ())
+        return result;
+
+    for (Step const & step : steps)
+    {
+        result = step.filter
+            ? step.filter->decide (event)
+            : step.levels.lookup (ll);
+        if (result != FilterResult::NEUTRAL)
+            return result;
+    }
+
+    return FilterResult::ACCEPT;
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // DenyAllFilter implementation
 ///////////////////////////////////////////////////////////////////////////////
@@ -96,6 +247,20 @@ DenyAllFilter::decide(const InternalLoggingEvent&) const
 }
 
 
+unsigned
+DenyAllFilter::getEventFields() const
+{
+    return EVENT_FIELDS_NONE;
+}
+
+
+bool
+DenyAllFilter::getLevelBreakpoints(std::vector<LogLevel>&) const
+{
+    return true;
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // LogLevelMatchFilter implementation
@@ -146,6 +311,28 @@ LogLevelMatchFilter::decide(const InternalLoggingEvent& event) const
 }
 
 
+unsigned
+LogLevelMatchFilter::getEventFields() const
+{
+    return EVENT_FIELDS_NONE;
+}
+
+
+bool
+LogLevelMatchFilter::getLevelBreakpoints(std::vector<LogLevel>& breakpoints)
+    const
+{
+    if (logLevelToMatch != NOT_SET_LOG_LEVEL)
+    {
+        breakpoints.push_back (logLevelToMatch);
+        if (logLevelToMatch != (std::numeric_limits<LogLevel>::max) ())
+            breakpoints.push_back (logLevelToMatch + 1);
+    }
+
+    return true;
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // LogLevelRangeFilter implementation
@@ -209,6 +396,27 @@ LogLevelRangeFilter::decide(const InternalLoggingEvent& event) const
 }
 
 
+unsigned
+LogLevelRangeFilter::getEventFields() const
+{
+    return EVENT_FIELDS_NONE;
+}
+
+
+bool
+LogLevelRangeFilter::getLevelBreakpoints(std::vector<LogLevel>& breakpoints)
+    const
+{
+    if (logLevelMin != NOT_SET_LOG_LEVEL)
+        breakpoints.push_back (logLevelMin);
+    if (logLevelMax != NOT_SET_LOG_LEVEL
+        && logLevelMax != (std::numeric_limits<LogLevel>::max) ())
+        breakpoints.push_back (logLevelMax + 1);
+
+    return true;
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // StringMatchFilter implementation
@@ -255,6 +463,580 @@ StringMatchFilter::decide(const InternalLoggingEvent& event) const
 }
 
 
+unsigned
+StringMatchFilter::getEventFields() const
+{
+    return EVENT_FIELDS_NONE;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// MultiStringMatchFilter implementation
+///////////////////////////////////////////////////////////////////////////////
+
+//! Deterministic Aho-Corasick automaton. Code units which occur in the
+//! strings to match are mapped to classes 1 through `classes - 1`, all
+//! other code units to class 0. Transitions of all states are complete,
+//! failure links are folded into them.
+struct MultiStringMatchFilter::Automaton
+{
+    typedef std::make_unsigned_t<tchar> unit_type;
+
+    std::uint32_t
+    classOf (tchar ch) const
+    {
+        unit_type const unit = static_cast<unit_type> (ch);
+        if (unit < narrowClasses.size ())
+            return narrowClasses[unit];
+
+        auto const it = std::lower_bound (wideClasses.begin (),
+            wideClasses.end (), unit,
+            [] (std::pair<unit_type, std::uint32_t> const & p, unit_type u)
+            { return p.first < u; });
+        if (it != wideClasses.end () && it->first == unit)
+            return it->second;
+        else
+            return 0;
+    }
+
+    std::size_t
+    skipToFirstUnit (tstring_view const & text, std::size_t pos) const
+    {
+        // With a single possible first code unit, defer to
+        // `char_traits::find()`, which is usually vectorized `memchr()`.
+        if (singleFirstUnit)
+        {
+            tchar const * const found = std::char_traits<tchar>::find (
+                text.data () + pos, text.size () - pos, firstUnit);
+            return found ? found - text.data () : text.size ();
+        }
+
+        while (pos != text.size () && ! delta[classOf (text[pos])])
+            ++pos;
+
+        return pos;
+    }
+
+    std::array<std::uint32_t, 256> narrowClasses {};
+    //! Classes of code units above 255, sorted by code unit.
+    std::vector<std::pair<unit_type, std::uint32_t>> wideClasses;
+    std::size_t classes = 1;
+    //! Next state, indexed by state * `classes` + class.
+    std::vector<std::uint32_t> delta;
+    //! Whether any of the strings ends in the state.
+    std::vector<char> accepting;
+    bool singleFirstUnit = false;
+    tchar firstUnit = 0;
+};
+
+
+MultiStringMatchFilter::MultiStringMatchFilter()
+    : acceptOnMatch (true)
+{
+    compile (std::vector<tstring> ());
+}
+
+
+MultiStringMatchFilter::MultiStringMatchFilter(
+    const helpers::Properties& properties)
+    : acceptOnMatch (true)
+{
+    properties.getBool (acceptOnMatch, LOG4CPLUS_TEXT("AcceptOnMatch"));
+
+    std::vector<tstring> strings;
+
+    helpers::Properties const stringProps
+        = properties.getPropertySubset (LOG4CPLUS_TEXT("StringToMatch."));
+    unsigned stringCount = 0;
+    tstring stringName;
+    while (stringProps.exists (
+        stringName = helpers::convertIntegerToString (++stringCount)))
+        strings.push_back (stringProps.getProperty (stringName));
+
+    tstring const & patternFile
+        = properties.getProperty (LOG4CPLUS_TEXT("PatternFile"));
+    if (! patternFile.empty ())
+    {
+        tifstream file (LOG4CPLUS_TSTRING_TO_STRING (patternFile).c_str ());
+        if (! file)
+            helpers::getLogLog ().error (
+                LOG4CPLUS_TEXT ("MultiStringMatchFilter- could not open file ")
+                + patternFile);
+
+        tstring line;
+        while (std::getline (file, line))
+        {
+            if (! line.empty () && line.back () == LOG4CPLUS_TEXT ('\r'))
+                line.pop_back ();
+            strings.push_back (std::move (line));
+        }
+    }
+
+    compile (strings);
+}
+
+
+MultiStringMatchFilter::MultiStringMatchFilter(
+    const std::vector<tstring>& stringsToMatch, bool acceptOnMatch_)
+    : acceptOnMatch (acceptOnMatch_)
+{
+    compile (stringsToMatch);
+}
+
+
+MultiStringMatchFilter::~MultiStringMatchFilter() = default;
+
+
+void
+MultiStringMatchFilter::compile(const std::vector<tstring>& strings)
+{
+    typedef Automaton::unit_type unit_type;
+    auto a = std::make_unique<Automaton> ();
+
+    // Assign classes to code units.
+
+    std::vector<unit_type> units;
+    for (tstring const & str : strings)
+        for (tchar ch : str)
+            units.push_back (static_cast<unit_type> (ch));
+    std::sort (units.begin (), units.end ());
+    units.erase (std::unique (units.begin (), units.end ()), units.end ());
+
+    for (unit_type unit : units)
+    {
+        std::uint32_t const cls = static_cast<std::uint32_t> (a->classes++);
+        if (unit < a->narrowClasses.size ())
+            a->narrowClasses[unit] = cls;
+        else
+            a->wideClasses.emplace_back (unit, cls);
+    }
+
+    // Build trie. Missing transitions are marked with `none`.
+
+    std::uint32_t const none = (std::numeric_limits<std::uint32_t>::max) ();
+    std::size_t const classes = a->classes;
+    a->delta.assign (classes, none);
+    a->accepting.assign (1, false);
+
+    for (tstring const & str : strings)
+    {
+        if (str.empty ())
+            continue;
+
+        std::uint32_t state = 0;
+        for (tchar ch : str)
+        {
+            std::uint32_t & next = a->delta[state * classes + a->classOf (ch)];
+            if (next == none)
+            {
+                next = static_cast<std::uint32_t> (a->accepting.size ());
+                a->delta.insert (a->delta.end (), classes, none);
+                a->accepting.push_back (false);
+            }
+            state = a->delta[state * classes + a->classOf (ch)];
+        }
+        a->accepting[state] = true;
+    }
+
+    // Remember possible first code units for skipping at root state.
+
+    std::size_t firstUnits = 0;
+    for (std::size_t cls = 1; cls != classes; ++cls)
+        if (a->delta[cls] != none)
+        {
+            ++firstUnits;
+            a->firstUnit = static_cast<tchar> (units[cls - 1]);
+        }
+    a->singleFirstUnit = firstUnits == 1;
+
+    // Fold failure links into transitions, breadth first.
+
+    std::vector<std::uint32_t> fail (a->accepting.size (), 0);
+    std::vector<std::uint32_t> queue;
+    for (std::size_t cls = 0; cls != classes; ++cls)
+    {
+        std::uint32_t & next = a->delta[cls];
+        if (next == none)
+            next = 0;
+        else
+            queue.push_back (next);
+    }
+
+    for (std::size_t i = 0; i != queue.size (); ++i)
+    {
+        std::uint32_t const state = queue[i];
+        a->accepting[state] = a->accepting[state]
+            || a->accepting[fail[state]];
+
+        for (std::size_t cls = 0; cls != classes; ++cls)
+        {
+            std::uint32_t & next = a->delta[state * classes + cls];
+            std::uint32_t const fallback = a->delta[fail[state] * classes + cls];
+            if (next == none)
+                next = fallback;
+            else
+            {
+                fail[next] = fallback;
+                queue.push_back (next);
+            }
+        }
+    }
+
+    automaton = std::move (a);
+}
+
+
+bool
+MultiStringMatchFilter::matches(const tstring_view& text) const
+{
+    Automaton const & a = *automaton;
+    std::size_t const classes = a.classes;
+    std::uint32_t state = 0;
+
+    for (std::size_t pos = 0; pos != text.size (); ++pos)
+    {
+        if (state == 0)
+        {
+            pos = a.skipToFirstUnit (text, pos);
+            if (pos == text.size ())
+                break;
+        }
+
+        state = a.delta[state * classes + a.classOf (text[pos])];
+        if (a.accepting[state])
+            return true;
+    }
+
+    return false;
+}
+
+
+FilterResult
+MultiStringMatchFilter::decide(const InternalLoggingEvent& event) const
+{
+    if (! matches (event.getMessage ()))
+        return FilterResult::NEUTRAL;
+    else
+        return acceptOnMatch ? FilterResult::ACCEPT : FilterResult::DENY;
+}
+
+
+unsigned
+MultiStringMatchFilter::getEventFields() const
+{
+    return EVENT_FIELDS_NONE;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// RateLimitFilter and SamplingFilter implementation
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+//! Parses the <b>Key</b> option of RateLimitFilter and SamplingFilter.
+FilterKey
+readFilterKey (helpers::Properties const & properties,
+    tstring const & filterName)
+{
+    tstring const value = helpers::toLower (
+        properties.getProperty (LOG4CPLUS_TEXT ("Key")));
+    if (value.empty () || value == LOG4CPLUS_TEXT ("logger"))
+        return FilterKey::LOGGER;
+    else if (value == LOG4CPLUS_TEXT ("callsite"))
+        return FilterKey::CALL_SITE;
+    else if (value == LOG4CPLUS_TEXT ("message"))
+        return FilterKey::MESSAGE;
+
+    helpers::getLogLog ().error (filterName
+        + LOG4CPLUS_TEXT ("- unknown Key: ") + value);
+    return FilterKey::LOGGER;
+}
+
+
+std::uint64_t
+hashFilterKey (FilterKey key, InternalLoggingEvent const & event)
+{
+    switch (key)
+    {
+    case FilterKey::CALL_SITE:
+        return std::hash<tstring> () (event.getFile ())
+            ^ (static_cast<std::uint64_t> (event.getLine ())
+                * 0x100000001b3ull);
+
+    case FilterKey::MESSAGE:
+    {
+        // FNV-1a of the message with decimal digits left out, so that
+        // messages differing only in numbers share a key.
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        for (tchar const ch : event.getMessage ())
+            if (ch < LOG4CPLUS_TEXT ('0') || ch > LOG4CPLUS_TEXT ('9'))
+                h = (h ^ static_cast<std::make_unsigned_t<tchar>> (ch))
+                    * 0x100000001b3ull;
+        return h;
+    }
+
+    case FilterKey::LOGGER:
+    default:
+        // Logger names are interned, equal names share storage.
+        return reinterpret_cast<std::uintptr_t> (
+            event.getLoggerNameHandle ().get ());
+    }
+}
+
+
+//! Fixed size table of atomic slots indexed by key hash. Keys which
+//! hash to the same slot share it, which keeps memory bounded.
+template <typename T>
+class FilterSlots
+{
+public:
+    explicit FilterSlots (unsigned count)
+        : shift (64 - std::bit_width (std::bit_ceil ((std::max) (count, 1u)) - 1))
+        , slots (std::make_unique<std::atomic<T>[]> (std::size_t {1} << (64 - shift)))
+    { }
+
+    std::atomic<T> &
+    operator [] (std::uint64_t hash) const
+    {
+        // Fibonacci hashing spreads keys with poor low bits, like
+        // pointers, across the table.
+        return slots[shift == 64
+            ? 0 : (hash * 0x9e3779b97f4a7c15ull) >> shift];
+    }
+
+private:
+    unsigned const shift;
+    std::unique_ptr<std::atomic<T>[]> const slots;
+};
+
+
+//! Counts suppressed events and reports them through LogLog at most
+//! once per interval.
+class SuppressionSummary
+{
+public:
+    SuppressionSummary (tstring filterName_,
+        helpers::SteadyClockGate::Duration interval)
+        : filterName (std::move (filterName_))
+        , gate (interval)
+    { }
+
+    void
+    record ()
+    {
+        gate.record_event ();
+        helpers::SteadyClockGate::Info info;
+        if (gate.latch_open (info))
+        {
+            tostringstream oss;
+            oss << filterName << LOG4CPLUS_TEXT (" suppressed ")
+                << info.count << LOG4CPLUS_TEXT (" events in last ")
+                << std::chrono::duration_cast<std::chrono::seconds> (
+                    info.time_span).count ()
+                << LOG4CPLUS_TEXT (" seconds");
+            helpers::getLogLog ().warn (oss.str ());
+        }
+    }
+
+private:
+    tstring const filterName;
+    helpers::SteadyClockGate gate;
+};
+
+
+unsigned
+readSlotCount (helpers::Properties const & properties)
+{
+    unsigned buckets = 1024;
+    properties.getUInt (buckets, LOG4CPLUS_TEXT ("Buckets"));
+    return buckets;
+}
+
+
+helpers::SteadyClockGate::Duration
+readSummaryInterval (helpers::Properties const & properties)
+{
+    unsigned seconds = 10;
+    properties.getUInt (seconds, LOG4CPLUS_TEXT ("SummaryInterval"));
+    return std::chrono::seconds (seconds);
+}
+
+
+unsigned
+keyEventFields (FilterKey key)
+{
+    return key == FilterKey::CALL_SITE
+        ? EVENT_FIELD_LOCATION : EVENT_FIELDS_NONE;
+}
+
+} // namespace
+
+
+//! Token buckets use the generic cell rate algorithm. Each slot holds
+//! theoretical arrival time of the next event, a bucket with all tokens
+//! available has it in the past.
+struct RateLimitFilter::State
+{
+    using Clock = std::chrono::steady_clock;
+    using Rep = Clock::duration::rep;
+
+    State (unsigned rate, unsigned burst, Clock::duration period,
+        unsigned buckets, Clock::duration summaryInterval)
+        : interval (rate == 0
+            ? 0 : (std::max) (period.count () / rate, Rep {1}))
+        , limit (interval * (std::max) (burst, 1u))
+        , slots (buckets)
+        , summary (LOG4CPLUS_TEXT ("RateLimitFilter"), summaryInterval)
+    { }
+
+    //! Time between two tokens, 0 disables the limit.
+    Rep const interval;
+    //! Furthest the theoretical arrival time may be ahead of now.
+    Rep const limit;
+    FilterSlots<Rep> const slots;
+    SuppressionSummary summary;
+};
+
+
+RateLimitFilter::RateLimitFilter()
+    : key (FilterKey::LOGGER)
+    , state (std::make_unique<State> (0, 0, std::chrono::seconds (1), 1,
+        std::chrono::seconds (10)))
+{ }
+
+
+RateLimitFilter::RateLimitFilter(const helpers::Properties& properties)
+    : key (readFilterKey (properties, LOG4CPLUS_TEXT ("RateLimitFilter")))
+{
+    unsigned rate = 0;
+    properties.getUInt (rate, LOG4CPLUS_TEXT ("Rate"));
+    unsigned burst = rate;
+    properties.getUInt (burst, LOG4CPLUS_TEXT ("Burst"));
+    unsigned period = 1;
+    properties.getUInt (period, LOG4CPLUS_TEXT ("Period"));
+
+    state = std::make_unique<State> (rate, burst,
+        std::chrono::seconds (period), readSlotCount (properties),
+        readSummaryInterval (properties));
+}
+
+
+RateLimitFilter::RateLimitFilter(unsigned rate, unsigned burst,
+    FilterKey key_, std::chrono::steady_clock::duration period)
+    : key (key_)
+    , state (std::make_unique<State> (rate, burst, period, 1024,
+        std::chrono::seconds (10)))
+{ }
+
+
+RateLimitFilter::~RateLimitFilter() = default;
+
+
+FilterResult
+RateLimitFilter::decide(const InternalLoggingEvent& event) const
+{
+    if (state->interval == 0)
+        return FilterResult::NEUTRAL;
+
+    State::Rep const now
+        = State::Clock::now ().time_since_epoch ().count ();
+    std::atomic<State::Rep> & tat = state->slots[hashFilterKey (key, event)];
+    State::Rep current = tat.load (std::memory_order_relaxed);
+    for (;;)
+    {
+        State::Rep const next = (std::max) (current, now) + state->interval;
+        if (next - now > state->limit)
+        {
+            state->summary.record ();
+            return FilterResult::DENY;
+        }
+
+        if (tat.compare_exchange_weak (current, next,
+                std::memory_order_relaxed))
+            return FilterResult::NEUTRAL;
+    }
+}
+
+
+unsigned
+RateLimitFilter::getEventFields() const
+{
+    return keyEventFields (key);
+}
+
+
+//
+//
+//
+
+struct SamplingFilter::State
+{
+    State (unsigned sampleEvery_, unsigned buckets,
+        helpers::SteadyClockGate::Duration summaryInterval)
+        : sampleEvery ((std::max) (sampleEvery_, 1u))
+        , slots (buckets)
+        , summary (LOG4CPLUS_TEXT ("SamplingFilter"), summaryInterval)
+    { }
+
+    std::uint64_t const sampleEvery;
+    FilterSlots<std::uint64_t> const slots;
+    SuppressionSummary summary;
+};
+
+
+SamplingFilter::SamplingFilter()
+    : key (FilterKey::LOGGER)
+    , state (std::make_unique<State> (1, 1, std::chrono::seconds (10)))
+{ }
+
+
+SamplingFilter::SamplingFilter(const helpers::Properties& properties)
+    : key (readFilterKey (properties, LOG4CPLUS_TEXT ("SamplingFilter")))
+{
+    unsigned sampleEvery = 1;
+    properties.getUInt (sampleEvery, LOG4CPLUS_TEXT ("SampleEvery"));
+
+    state = std::make_unique<State> (sampleEvery,
+        readSlotCount (properties), readSummaryInterval (properties));
+}
+
+
+SamplingFilter::SamplingFilter(unsigned sampleEvery, FilterKey key_)
+    : key (key_)
+    , state (std::make_unique<State> (sampleEvery, 1024,
+        std::chrono::seconds (10)))
+{ }
+
+
+SamplingFilter::~SamplingFilter() = default;
+
+
+FilterResult
+SamplingFilter::decide(const InternalLoggingEvent& event) const
+{
+    if (state->sampleEvery == 1)
+        return FilterResult::NEUTRAL;
+
+    std::uint64_t const n = state->slots[hashFilterKey (key, event)]
+        .fetch_add (1, std::memory_order_relaxed);
+    if (n % state->sampleEvery == 0)
+        return FilterResult::NEUTRAL;
+
+    state->summary.record ();
+    return FilterResult::DENY;
+}
+
+
+unsigned
+SamplingFilter::getEventFields() const
+{
+    return keyEventFields (key);
+}
+
+
 //
 //
 //
@@ -310,6 +1092,13 @@ FilterResult NDCMatchFilter::decide(const InternalLoggingEvent& event) const
     return (acceptOnMatch ? FilterResult::DENY : FilterResult::ACCEPT);
 }
 
+
+unsigned
+NDCMatchFilter::getEventFields() const
+{
+    return EVENT_FIELD_NDC;
+}
+
 //
 // MDC Match filter
 //
@@ -353,6 +1142,13 @@ FilterResult MDCMatchFilter::decide(const InternalLoggingEvent& event) const
 }
 
 
+unsigned
+MDCMatchFilter::getEventFields() const
+{
+    return EVENT_FIELD_MDC;
+}
+
+
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
 CATCH_TEST_CASE ("Filter", "[filter]")
 {
@@ -485,6 +1281,166 @@ CATCH_TEST_CASE ("Filter", "[filter]")
         }
     }
 
+    CATCH_SECTION ("multi string match filter")
+    {
+        CATCH_SECTION ("no strings is neutral")
+        {
+            filter = new MultiStringMatchFilter;
+            CATCH_REQUIRE (filter->decide (info_ev) == FilterResult::NEUTRAL);
+            CATCH_REQUIRE (filter->decide (empty_ev) == FilterResult::NEUTRAL);
+        }
+
+        CATCH_SECTION ("overlapping strings")
+        {
+            MultiStringMatchFilter const f (std::vector<tstring> {
+                LOG4CPLUS_TEXT ("she"), LOG4CPLUS_TEXT ("hers"),
+                LOG4CPLUS_TEXT ("his"), LOG4CPLUS_TEXT ("ushers!")});
+            CATCH_REQUIRE (f.matches (LOG4CPLUS_TEXT ("ushe")));
+            CATCH_REQUIRE (f.matches (LOG4CPLUS_TEXT ("xhers")));
+            CATCH_REQUIRE (f.matches (LOG4CPLUS_TEXT ("ahishe")));
+            CATCH_REQUIRE (! f.matches (LOG4CPLUS_TEXT ("hehehe")));
+            CATCH_REQUIRE (! f.matches (LOG4CPLUS_TEXT ("")));
+        }
+
+        CATCH_SECTION ("single first code unit")
+        {
+            MultiStringMatchFilter const f (std::vector<tstring> {
+                LOG4CPLUS_TEXT ("error"), LOG4CPLUS_TEXT ("eof")});
+            CATCH_REQUIRE (f.matches (LOG4CPLUS_TEXT ("unexpected eof")));
+            CATCH_REQUIRE (! f.matches (LOG4CPLUS_TEXT ("erro eo")));
+        }
+
+        CATCH_SECTION ("deny on match")
+        {
+            helpers::Properties props;
+            props.setProperty (LOG4CPLUS_TEXT ("StringToMatch.1"),
+                LOG4CPLUS_TEXT ("nonexistent"));
+            props.setProperty (LOG4CPLUS_TEXT ("StringToMatch.2"),
+                LOG4CPLUS_TEXT ("warn log"));
+            props.setProperty (LOG4CPLUS_TEXT ("StringToMatch.3"),
+                LOG4CPLUS_TEXT ("fatal"));
+            props.setProperty (LOG4CPLUS_TEXT ("AcceptOnMatch"),
+                LOG4CPLUS_TEXT ("false"));
+            filter = new MultiStringMatchFilter (props);
+            CATCH_REQUIRE (filter->decide (info_ev) == FilterResult::NEUTRAL);
+            CATCH_REQUIRE (filter->decide (warn_ev) == FilterResult::DENY);
+            CATCH_REQUIRE (filter->decide (fatal_ev) == FilterResult::DENY);
+        }
+    }
+
+    CATCH_SECTION ("rate limit filter")
+    {
+        CATCH_SECTION ("no rate is neutral")
+        {
+            filter = new RateLimitFilter;
+            for (int i = 0; i != 10; ++i)
+                CATCH_REQUIRE (filter->decide (info_ev)
+                    == FilterResult::NEUTRAL);
+        }
+
+        CATCH_SECTION ("burst then deny")
+        {
+            helpers::Properties props;
+            props.setProperty (LOG4CPLUS_TEXT ("Rate"), LOG4CPLUS_TEXT ("1"));
+            props.setProperty (LOG4CPLUS_TEXT ("Period"),
+                LOG4CPLUS_TEXT ("3600"));
+            props.setProperty (LOG4CPLUS_TEXT ("Burst"), LOG4CPLUS_TEXT ("3"));
+            props.setProperty (LOG4CPLUS_TEXT ("Key"),
+                LOG4CPLUS_TEXT ("Message"));
+            filter = new RateLimitFilter (props);
+            CATCH_REQUIRE (filter->getEventFields () == EVENT_FIELDS_NONE);
+            for (int i = 0; i != 3; ++i)
+                CATCH_REQUIRE (filter->decide (info_ev)
+                    == FilterResult::NEUTRAL);
+            CATCH_REQUIRE (filter->decide (info_ev) == FilterResult::DENY);
+            // Different message template has its own bucket.
+            CATCH_REQUIRE (filter->decide (warn_ev) == FilterResult::NEUTRAL);
+        }
+
+        CATCH_SECTION ("call site key")
+        {
+            RateLimitFilter const f (1, 1, FilterKey::CALL_SITE,
+                std::chrono::hours (1));
+            CATCH_REQUIRE (f.getEventFields () == EVENT_FIELD_LOCATION);
+            InternalLoggingEvent const ev1 (log.getName (), INFO_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("message 1"), "file.cxx", 1);
+            InternalLoggingEvent const ev2 (log.getName (), INFO_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("message 2"), "file.cxx", 1);
+            InternalLoggingEvent const ev3 (log.getName (), INFO_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("message 1"), "file.cxx", 2);
+            CATCH_REQUIRE (f.decide (ev1) == FilterResult::NEUTRAL);
+            CATCH_REQUIRE (f.decide (ev2) == FilterResult::DENY);
+            CATCH_REQUIRE (f.decide (ev3) == FilterResult::NEUTRAL);
+        }
+    }
+
+    CATCH_SECTION ("sampling filter")
+    {
+        helpers::Properties props;
+        props.setProperty (LOG4CPLUS_TEXT ("SampleEvery"),
+            LOG4CPLUS_TEXT ("3"));
+        filter = new SamplingFilter (props);
+        CATCH_REQUIRE (filter->decide (info_ev) == FilterResult::NEUTRAL);
+        CATCH_REQUIRE (filter->decide (info_ev) == FilterResult::DENY);
+        CATCH_REQUIRE (filter->decide (warn_ev) == FilterResult::DENY);
+        CATCH_REQUIRE (filter->decide (info_ev) == FilterResult::NEUTRAL);
+    }
+
+    CATCH_SECTION ("compiled filter chain")
+    {
+        helpers::Properties rangeProps;
+        rangeProps.setProperty (LOG4CPLUS_TEXT ("LogLevelMin"),
+            LOG4CPLUS_TEXT ("INFO"));
+        rangeProps.setProperty (LOG4CPLUS_TEXT ("LogLevelMax"),
+            LOG4CPLUS_TEXT ("ERROR"));
+        rangeProps.setProperty (LOG4CPLUS_TEXT ("AcceptOnMatch"),
+            LOG4CPLUS_TEXT ("false"));
+        helpers::Properties matchProps;
+        matchProps.setProperty (LOG4CPLUS_TEXT ("LogLevelToMatch"),
+            LOG4CPLUS_TEXT ("WARN"));
+        helpers::Properties stringProps;
+        stringProps.setProperty (LOG4CPLUS_TEXT ("StringToMatch"),
+            LOG4CPLUS_TEXT ("error"));
+
+        auto require_same = [&] (FilterPtr const & head) {
+            CompiledFilterChain const chain (head);
+            for (auto const * ev : {&debug_ev, &info_ev, &empty_ev, &warn_ev,
+                     &error_ev, &fatal_ev})
+                CATCH_REQUIRE (chain.check (*ev)
+                    == checkFilter (head.get (), *ev));
+        };
+
+        CATCH_SECTION ("empty chain accepts")
+        {
+            CATCH_REQUIRE (CompiledFilterChain ().check (info_ev)
+                == FilterResult::ACCEPT);
+        }
+
+        CATCH_SECTION ("level filters only")
+        {
+            filter = new LogLevelMatchFilter (matchProps);
+            filter->appendFilter (FilterPtr (new LogLevelRangeFilter (rangeProps)));
+            filter->appendFilter (FilterPtr (new DenyAllFilter));
+            require_same (filter);
+        }
+
+        CATCH_SECTION ("level filters around dynamic filter")
+        {
+            filter = new LogLevelRangeFilter (rangeProps);
+            filter->appendFilter (FilterPtr (new StringMatchFilter (stringProps)));
+            filter->appendFilter (FilterPtr (new LogLevelMatchFilter (matchProps)));
+            filter->appendFilter (FilterPtr (new DenyAllFilter));
+            require_same (filter);
+        }
+
+        CATCH_SECTION ("dynamic filter first")
+        {
+            filter = new StringMatchFilter (stringProps);
+            filter->appendFilter (FilterPtr (new LogLevelMatchFilter (matchProps)));
+            require_same (filter);
+        }
+    }
+
     CATCH_SECTION ("function filter")
     {
         filter = new FunctionFilter (
@@ -25,6 +25,9 @@
 #  include <log4cplus/config/windowsh-inc-full.h>
 #  define CATCH_CONFIG_RUNNER
 #  include <catch_amalgamated.hpp>
+#  include <log4cplus/appender.h>
+#  include <log4cplus/helpers/property.h>
+#  include <log4cplus/helpers/stringhelper.h>
 #endif
 
 #include <log4cplus/initializer.h>
@@ -44,10 +47,13 @@
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
 #include "ThreadPool.h"
 #endif
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <chrono>
+#include <thread>
 
 
 // Forward Declarations
@@ -136,15 +142,189 @@ namespace
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
 static
 std::unique_ptr<progschj::ThreadPool>
-instantiate_thread_pool ()
+instantiate_thread_pool ([[maybe_unused]] std::size_t pool_size)
 {
     log4cplus::thread::SignalsBlocker sb;
 #if defined (LOG4CPLUS_ENABLE_THREAD_POOL)
-    return std::unique_ptr<progschj::ThreadPool>(new progschj::ThreadPool (4));
+    return std::unique_ptr<progschj::ThreadPool>(
+        new progschj::ThreadPool (pool_size));
 #else
     return std::unique_ptr<progschj::ThreadPool>();
 #endif
 }
+
+
+//! Default limit of events queued by one asynchronous appender.
+std::size_t const DEFAULT_ASYNC_QUEUE_SIZE_LIMIT = 100000;
+
+
+//! Sizing policy of the thread pool. The pool is created with `min_size`
+//! threads when it is first needed. Each queued task drains a batch of
+//! events of one asynchronous appender. The pool grows by one thread
+//! whenever the number of queued tasks per thread exceeds
+//! `queue_depth_threshold` or a worker picks up a task that has waited
+//! longer than `latency_threshold`, up to `max_size` threads. It shrinks
+//! by one thread whenever a worker finishes a task, finds the queue empty
+//! and the pool has not been backlogged for `idle_timeout`.
+struct ThreadPoolScaling
+{
+    using Clock = std::chrono::steady_clock;
+
+    static Clock::rep
+    ticks (Clock::duration d)
+    {
+        return d.count ();
+    }
+
+    static Clock::rep
+    now_ticks ()
+    {
+        return ticks (Clock::now ().time_since_epoch ());
+    }
+
+    static std::size_t
+    default_max_size ()
+    {
+        return (std::max) (std::size_t (4),
+            std::size_t (std::thread::hardware_concurrency ()));
+    }
+
+    std::atomic<std::size_t> min_size {1};
+    std::atomic<std::size_t> max_size {default_max_size ()};
+    std::atomic<Clock::rep> idle_timeout {
+        ticks (std::chrono::seconds (60))};
+    std::atomic<std::size_t> queue_depth_threshold {2};
+    std::atomic<Clock::rep> latency_threshold {
+        ticks (std::chrono::milliseconds (10))};
+    //! Limit of events queued by each asynchronous appender. Zero keeps
+    //! the default, DEFAULT_ASYNC_QUEUE_SIZE_LIMIT.
+    std::atomic<std::size_t> queue_size_limit {0};
+    //! Limit of tasks queued in the thread pool itself. Zero keeps the
+    //! default of the pool.
+    std::atomic<std::size_t> task_queue_size_limit {0};
+
+    //! Number of threads last requested from the pool.
+    std::atomic<std::size_t> pool_size {0};
+    //! Tasks enqueued but not yet picked up by a worker.
+    std::atomic<std::size_t> queued {0};
+    //! Last time the pool was backlogged or resized.
+    std::atomic<Clock::rep> last_busy {0};
+    //! Serializes creation and resizing of the pool.
+    std::mutex resize_mutex;
+
+    std::size_t
+    lower_bound () const
+    {
+        return (std::max) (min_size.load (std::memory_order_relaxed),
+            std::size_t (1));
+    }
+
+    std::size_t
+    upper_bound () const
+    {
+        return (std::max) (max_size.load (std::memory_order_relaxed),
+            lower_bound ());
+    }
+
+    //! Brings pool size within current limits. Caller holds
+    //! `resize_mutex`.
+    void
+    apply_limits (progschj::ThreadPool & tp)
+    {
+        std::size_t const size = (std::clamp) (
+            pool_size.load (std::memory_order_relaxed), lower_bound (),
+            upper_bound ());
+        resize (tp, size);
+
+        if (std::size_t const limit
+            = task_queue_size_limit.load (std::memory_order_relaxed))
+            tp.set_queue_size_limit (limit);
+    }
+
+    void
+    resize (progschj::ThreadPool & tp, std::size_t size)
+    {
+        last_busy.store (now_ticks (), std::memory_order_relaxed);
+        if (pool_size.exchange (size, std::memory_order_relaxed) != size)
+            tp.set_pool_size (size);
+    }
+
+    //! Adds one thread unless the pool is at its maximum or another
+    //! thread is resizing it right now.
+    void
+    grow (progschj::ThreadPool & tp)
+    {
+        std::unique_lock<std::mutex> guard (resize_mutex, std::try_to_lock);
+        if (! guard.owns_lock ())
+            return;
+
+        std::size_t const size = pool_size.load (std::memory_order_relaxed);
+        if (size < upper_bound ())
+            resize (tp, size + 1);
+    }
+
+    void
+    shrink (progschj::ThreadPool & tp)
+    {
+        std::unique_lock<std::mutex> guard (resize_mutex, std::try_to_lock);
+        if (! guard.owns_lock ())
+            return;
+
+        std::size_t const size = pool_size.load (std::memory_order_relaxed);
+        if (size > lower_bound ())
+        {
+            // Do not touch `last_busy`, following idle workers keep
+            // shrinking the pool down to its minimum.
+            pool_size.store (size - 1, std::memory_order_relaxed);
+            tp.set_pool_size (size - 1);
+        }
+    }
+
+    //! Called by the producer before the task is enqueued.
+    void
+    on_enqueue (progschj::ThreadPool & tp)
+    {
+        std::size_t const depth
+            = queued.fetch_add (1, std::memory_order_relaxed) + 1;
+        if (depth > queue_depth_threshold.load (std::memory_order_relaxed)
+            * pool_size.load (std::memory_order_relaxed))
+            grow (tp);
+    }
+
+    //! Called by the producer when a task counted by on_enqueue()
+    //! could not be enqueued after all.
+    void
+    on_dropped ()
+    {
+        queued.fetch_sub (1, std::memory_order_relaxed);
+    }
+
+    //! Called by a worker before it runs a task enqueued at
+    //! `enqueued`.
+    void
+    on_dequeue (progschj::ThreadPool & tp, Clock::rep enqueued)
+    {
+        Clock::rep const now = now_ticks ();
+        if (queued.fetch_sub (1, std::memory_order_relaxed) > 1)
+            last_busy.store (now, std::memory_order_relaxed);
+
+        if (now - enqueued > latency_threshold.load (std::memory_order_relaxed))
+            grow (tp);
+    }
+
+    //! Called by a worker after it has run a task.
+    void
+    on_done (progschj::ThreadPool & tp)
+    {
+        if (queued.load (std::memory_order_relaxed) != 0
+            || pool_size.load (std::memory_order_relaxed) <= lower_bound ())
+            return;
+
+        if (now_ticks () - last_busy.load (std::memory_order_relaxed)
+            >= idle_timeout.load (std::memory_order_relaxed))
+            shrink (tp);
+    }
+};
 #endif
 
 
@@ -188,6 +368,9 @@ struct DefaultContext
     Hierarchy hierarchy;
     ThreadPoolHolder thread_pool;
     std::atomic<bool> block_on_full {true};
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    ThreadPoolScaling thread_pool_scaling;
+#endif
 
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
     progschj::ThreadPool *
@@ -195,7 +378,16 @@ struct DefaultContext
     {
         if (init) {
             std::call_once (thread_pool_once, [&] {
-                thread_pool.thread_pool.store (instantiate_thread_pool ().release (), std::memory_order_release);
+                ThreadPoolScaling & scaling = thread_pool_scaling;
+                std::lock_guard<std::mutex> guard (scaling.resize_mutex);
+                std::size_t const size = scaling.lower_bound ();
+                auto tp = instantiate_thread_pool (size);
+                if (tp)
+                {
+                    scaling.pool_size.store (size, std::memory_order_relaxed);
+                    scaling.apply_limits (*tp);
+                }
+                thread_pool.thread_pool.store (tp.release (), std::memory_order_release);
             });
         }
         // cppreference.com says: The specification of release-consume ordering
@@ -368,46 +560,47 @@ getMDC ()
 #if ! defined (LOG4CPLUS_SINGLE_THREADED) \
     && defined (LOG4CPLUS_ENABLE_THREAD_POOL)
 void
-enqueueAsyncDoAppend (SharedAppenderPtr const & appender,
-    spi::InternalLoggingEvent const & event)
+enqueueAsyncTask (std::function<void ()> task)
 {
-    static helpers::SteadyClockGate gate (helpers::SteadyClockGate::Duration {std::chrono::minutes (5)});
-
     DefaultContext * dc = get_dc ();
     progschj::ThreadPool * tp = dc->get_thread_pool (true);
-    auto func = [=] () {
-        appender->asyncDoAppend (event);
+    if (! tp)
+        throw std::runtime_error ("thread pool is not available");
+
+    auto func = [task = std::move (task), dc,
+        enqueued = ThreadPoolScaling::now_ticks ()]
+    () {
+        progschj::ThreadPool * const pool = dc->get_thread_pool (false);
+        if (pool)
+            dc->thread_pool_scaling.on_dequeue (*pool, enqueued);
+        task ();
+        if (pool)
+            dc->thread_pool_scaling.on_done (*pool);
     };
-    if (dc->block_on_full)
+    ThreadPoolScaling & scaling = dc->thread_pool_scaling;
+    try
+    {
+        scaling.on_enqueue (*tp);
+        // Each asynchronous appender has at most one task queued, the
+        // events themselves are bounded by queues of the appenders.
         tp->enqueue_block (std::move (func));
-    else
+    }
+    catch (...)
     {
-        std::future<void> future = tp->enqueue (std::move (func));
-        if (future.wait_for (std::chrono::seconds (0)) == std::future_status::ready)
-        {
-            try
-            {
-                future.get ();
-            }
-            catch (const progschj::would_block &)
-            {
-                gate.record_event ();
-                helpers::SteadyClockGate::Info info;
-                if (gate.latch_open (info))
-                {
-                    helpers::LogLog & loglog = helpers::getLogLog ();
-                    log4cplus::tostringstream oss;
-                    oss << LOG4CPLUS_TEXT ("Asynchronous logging queue is full. Dropped ")
-                        << info.count << LOG4CPLUS_TEXT (" events in last ")
-                        << std::chrono::duration_cast<std::chrono::seconds> (info.time_span).count ()
-                        << LOG4CPLUS_TEXT (" seconds");
-                    loglog.warn (oss.str ());
-                }
-            }
-        }
+        scaling.on_dropped ();
+        throw;
     }
 }
 
+
+std::size_t
+getAsyncQueueSizeLimit ()
+{
+    std::size_t const limit = get_dc ()->thread_pool_scaling.queue_size_limit
+        .load (std::memory_order_relaxed);
+    return limit != 0 ? limit : DEFAULT_ASYNC_QUEUE_SIZE_LIMIT;
+}
+
 #endif
 
 void
@@ -683,14 +876,85 @@ threadCleanup ()
 }
 
 
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+//! Updates sizing of the thread pool through `update` and applies it to
+//! the pool if it already exists. The pool is not created here, it is
+//! created on first asynchronous use with the settings in effect.
+template <typename Update>
+static
+void
+updateThreadPoolScaling (Update const & update)
+{
+    DefaultContext * const dc = get_dc ();
+    ThreadPoolScaling & scaling = dc->thread_pool_scaling;
+    std::lock_guard<std::mutex> guard (scaling.resize_mutex);
+    update (scaling);
+    if (progschj::ThreadPool * const tp = dc->get_thread_pool (false))
+        scaling.apply_limits (*tp);
+}
+#endif
+
+
 void
 setThreadPoolSize (std::size_t LOG4CPLUS_THREADED (pool_size))
 {
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    auto const thread_pool = get_dc ()->get_thread_pool (true);
-    if (thread_pool)
-        thread_pool->set_pool_size (pool_size);
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.min_size.store (pool_size, std::memory_order_relaxed);
+        scaling.max_size.store (pool_size, std::memory_order_relaxed);
+    });
+#endif
+}
+
 
+void
+setThreadPoolMinSize (std::size_t LOG4CPLUS_THREADED (min_size))
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.min_size.store (min_size, std::memory_order_relaxed);
+    });
+#endif
+}
+
+
+void
+setThreadPoolMaxSize (std::size_t LOG4CPLUS_THREADED (max_size))
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.max_size.store (max_size, std::memory_order_relaxed);
+    });
+#endif
+}
+
+
+void
+setThreadPoolIdleTimeout (
+    std::chrono::milliseconds LOG4CPLUS_THREADED (idle_timeout))
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.idle_timeout.store (ThreadPoolScaling::ticks (idle_timeout),
+            std::memory_order_relaxed);
+    });
+#endif
+}
+
+
+void
+setThreadPoolScaleUpThresholds (
+    std::size_t LOG4CPLUS_THREADED (queue_depth),
+    std::chrono::milliseconds LOG4CPLUS_THREADED (latency))
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.queue_depth_threshold.store (
+            (std::max) (queue_depth, std::size_t (1)),
+            std::memory_order_relaxed);
+        scaling.latency_threshold.store (ThreadPoolScaling::ticks (latency),
+            std::memory_order_relaxed);
+    });
 #endif
 }
 
@@ -699,10 +963,23 @@ void
 setThreadPoolQueueSizeLimit (std::size_t LOG4CPLUS_THREADED (queue_size_limit))
 {
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    auto const thread_pool = get_dc ()->get_thread_pool (true);
-    if (thread_pool)
-        thread_pool->set_queue_size_limit (queue_size_limit);
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.queue_size_limit.store (queue_size_limit,
+            std::memory_order_relaxed);
+    });
+#endif
+}
+
 
+void
+setThreadPoolTaskQueueSizeLimit (
+    std::size_t LOG4CPLUS_THREADED (task_queue_size_limit))
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    updateThreadPoolScaling ([&] (ThreadPoolScaling & scaling) {
+        scaling.task_queue_size_limit.store (task_queue_size_limit,
+            std::memory_order_relaxed);
+    });
 #endif
 }
 
@@ -713,6 +990,13 @@ setThreadPoolBlockOnFull (bool block)
     get_dc ()->block_on_full.store (block);
 }
 
+
+bool
+getThreadPoolBlockOnFull ()
+{
+    return get_dc ()->block_on_full.load (std::memory_order_relaxed);
+}
+
 static
 void
 freeTLSSlot ()
@@ -819,6 +1103,167 @@ thread_callback_terminator(LPVOID hinstDLL, DWORD fdwReason, LPVOID lpReserved)
 
 
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#if ! defined (LOG4CPLUS_SINGLE_THREADED) \
+    && defined (LOG4CPLUS_ENABLE_THREAD_POOL)
+CATCH_TEST_CASE ("Thread pool scaling", "[thread_pool]")
+{
+    progschj::ThreadPool tp (1);
+    ThreadPoolScaling scaling;
+    scaling.min_size = 1;
+    scaling.max_size = 3;
+    scaling.queue_depth_threshold = 2;
+    scaling.pool_size = 1;
+
+    CATCH_SECTION ("grows with queue depth up to maximum")
+    {
+        for (int i = 0; i != 2; ++i)
+            scaling.on_enqueue (tp);
+        CATCH_REQUIRE (scaling.pool_size == 1);
+
+        scaling.on_enqueue (tp);
+        CATCH_REQUIRE (scaling.pool_size == 2);
+
+        for (int i = 0; i != 20; ++i)
+            scaling.on_enqueue (tp);
+        CATCH_REQUIRE (scaling.pool_size == 3);
+    }
+
+    CATCH_SECTION ("grows with latency")
+    {
+        scaling.on_enqueue (tp);
+        scaling.on_dequeue (tp, ThreadPoolScaling::now_ticks ());
+        CATCH_REQUIRE (scaling.pool_size == 1);
+
+        scaling.on_enqueue (tp);
+        scaling.on_dequeue (tp, ThreadPoolScaling::now_ticks ()
+            - ThreadPoolScaling::ticks (std::chrono::seconds (1)));
+        CATCH_REQUIRE (scaling.pool_size == 2);
+    }
+
+    CATCH_SECTION ("shrinks to minimum when idle")
+    {
+        for (int i = 0; i != 5; ++i)
+            scaling.on_enqueue (tp);
+        CATCH_REQUIRE (scaling.pool_size == 3);
+
+        for (int i = 0; i != 5; ++i)
+        {
+            scaling.on_dequeue (tp, ThreadPoolScaling::now_ticks ());
+            scaling.on_done (tp);
+        }
+        // Default idle timeout has not expired yet.
+        CATCH_REQUIRE (scaling.pool_size == 3);
+
+        scaling.idle_timeout = 0;
+        scaling.on_done (tp);
+        scaling.on_done (tp);
+        scaling.on_done (tp);
+        CATCH_REQUIRE (scaling.pool_size == 1);
+    }
+
+    CATCH_SECTION ("dropped tasks are not counted as queued")
+    {
+        scaling.on_enqueue (tp);
+        scaling.on_dropped ();
+        CATCH_REQUIRE (scaling.queued == 0);
+    }
+
+    CATCH_SECTION ("event limit does not limit pool tasks")
+    {
+        std::size_t const pool_default = tp.get_queue_size_limit ();
+        scaling.queue_size_limit = 100;
+        scaling.apply_limits (tp);
+        CATCH_REQUIRE (tp.get_queue_size_limit () == pool_default);
+
+        scaling.task_queue_size_limit = 10;
+        scaling.apply_limits (tp);
+        CATCH_REQUIRE (tp.get_queue_size_limit () == 10);
+    }
+}
+
+
+namespace
+{
+
+class RecordingAppender
+    : public Appender
+{
+public:
+    explicit RecordingAppender (helpers::Properties const & props)
+        : Appender (props)
+    { }
+
+    ~RecordingAppender () override
+    {
+        destructorImpl ();
+    }
+
+    void close () override
+    {
+        closed = true;
+    }
+
+    std::vector<tstring> messages;
+
+protected:
+    void append (spi::InternalLoggingEvent const & event) override
+    {
+        messages.push_back (event.getMessage ());
+    }
+};
+
+} // namespace
+
+
+CATCH_TEST_CASE ("Asynchronous append survives failure to queue",
+    "[appender][thread_pool]")
+{
+    helpers::Properties props;
+    props.setProperty (LOG4CPLUS_TEXT ("AsyncAppend"), LOG4CPLUS_TEXT ("true"));
+    helpers::SharedObjectPtr<RecordingAppender> const appender (
+        new RecordingAppender (props));
+
+    // Take the thread pool away the way shutdownThreadPool() does, so that
+    // enqueueAsyncTask() fails to queue drain tasks, and put it back on
+    // every exit path.
+    struct HiddenThreadPool
+    {
+        explicit HiddenThreadPool (DefaultContext * ctx)
+            : dc (ctx)
+        {
+            dc->get_thread_pool (true);
+            waitUntilEmptyThreadPoolQueue ();
+            tp = dc->thread_pool.thread_pool.exchange (nullptr);
+        }
+
+        ~HiddenThreadPool ()
+        {
+            dc->thread_pool.thread_pool.store (tp);
+        }
+
+        DefaultContext * dc;
+        progschj::ThreadPool * tp;
+    };
+
+    std::vector<tstring> expected;
+    {
+        HiddenThreadPool const hidden (get_dc ());
+        for (int i = 0; i != 10; ++i)
+        {
+            expected.push_back (helpers::convertIntegerToString (i));
+            spi::InternalLoggingEvent const event (LOG4CPLUS_TEXT ("strand"),
+                INFO_LOG_LEVEL, expected.back (), __FILE__, __LINE__);
+            appender->doAppend (event);
+        }
+    }
+
+    // Events are appended synchronously and none is left in flight.
+    CATCH_REQUIRE (appender->messages == expected);
+    appender->waitToFinishAsyncLogging ();
+}
+#endif
+
+
 LOG4CPLUS_EXPORT int unit_tests_main (int argc, char* argv[]);
 int
 unit_tests_main (int argc, char * argv[])
@@ -24,34 +24,16 @@
 #include <log4cplus/spi/rootlogger.h>
 #include <log4cplus/thread/syncprims-pub-impl.h>
 #include <utility>
+#include <algorithm>
 #include <limits>
+#include <mutex>
+#include <shared_mutex>
 
 
 namespace log4cplus
 {
 
 
-//////////////////////////////////////////////////////////////////////////////
-// File "Local" methods
-//////////////////////////////////////////////////////////////////////////////
-
-namespace
-{
-
-static
-bool startsWith(tstring_view const & teststr, tstring_view const & substr)
-{
-    bool val = false;
-    tstring::size_type const len = substr.length();
-    if (teststr.length() > len)
-        val = teststr.compare (0, len, substr) == 0;
-
-    return val;
-}
-
-} // namespace
-
-
 //////////////////////////////////////////////////////////////////////////////
 // Hierarchy static declarations
 //////////////////////////////////////////////////////////////////////////////
@@ -73,6 +55,7 @@ Hierarchy::Hierarchy()
   , emittedNoAppenderWarning(false)
 {
     root = Logger( new spi::RootLogger(*this, DEBUG_LOG_LEVEL) );
+    loggerTrie = newTrieNode ();
 }
 
 
@@ -92,8 +75,16 @@ Hierarchy::clear()
 {
     thread::MutexGuard guard (hashtable_mutex);
 
-    provisionNodes.erase(provisionNodes.begin(), provisionNodes.end());
-    loggerPtrs.erase(loggerPtrs.begin(), loggerPtrs.end());
+    resetLoggerTrie ();
+    for (auto & shard : loggerPtrs)
+    {
+        std::unique_lock shard_guard (shard.mtx);
+        shard.loggers.clear ();
+    }
+
+    // Dispatch lists of all loggers include the generation of the root
+    // logger.
+    root.value->invalidateDispatchList (false);
 }
 
 
@@ -104,10 +95,7 @@ Hierarchy::exists(const tstring_view& name)
     if (name.empty ())
         return true;
 
-    thread::MutexGuard guard (hashtable_mutex);
-
-    auto it = loggerPtrs.find(name);
-    return it != loggerPtrs.end();
+    return findLogger (HashedName (name)).value != nullptr;
 }
 
 
@@ -167,12 +155,43 @@ Hierarchy::getInstance(const tstring_view& name)
 Logger
 Hierarchy::getInstance(const tstring_view& name, spi::LoggerFactory& factory)
 {
+    if (name.empty ())
+        return root;
+
+    // Fast path: existing logger is found under shared lock of one shard
+    // of the logger table, without touching `hashtable_mutex`.
+    if (Logger logger = findLogger (HashedName (name)); logger.value)
+        return logger;
+
     thread::MutexGuard guard (hashtable_mutex);
 
     return getInstanceImpl(name, factory);
 }
 
 
+LoggerList
+Hierarchy::getInstances(const std::vector<tstring>& names)
+{
+    LoggerList ret;
+    ret.reserve (names.size ());
+
+    thread::MutexGuard guard (hashtable_mutex);
+
+    // Avoid repeated rehashing of the shards while the batch is inserted.
+    for (auto & shard : loggerPtrs)
+    {
+        std::unique_lock shard_guard (shard.mtx);
+        shard.loggers.reserve (shard.loggers.size ()
+            + names.size () / LOGGER_MAP_SHARDS);
+    }
+
+    for (tstring const & name : names)
+        ret.push_back (getInstanceImpl (name, *defaultFactory));
+
+    return ret;
+}
+
+
 LoggerList
 Hierarchy::getCurrentLoggers()
 {
@@ -183,6 +202,11 @@ Hierarchy::getCurrentLoggers()
         initializeLoggerList(ret);
     }
 
+    // The sharded logger map has no stable iteration order.
+    std::sort (ret.begin (), ret.end (),
+        [] (Logger const & a, Logger const & b) {
+            return a.getName () < b.getName (); });
+
     return ret;
 }
 
@@ -279,16 +303,27 @@ Hierarchy::getInstanceImpl(const tstring_view& name,
     spi::LoggerFactory& factory)
 {
     Logger logger;
+    HashedName const hn (name);
+    LoggerMapShard & shard = getShard (hn);
 
     if (name.empty ())
         logger = root;
-    else if (auto lm_it = loggerPtrs.find(name); lm_it != loggerPtrs.end())
+    else if (auto lm_it = shard.loggers.find(hn); lm_it != shard.loggers.end())
         logger = lm_it->second;
     else
     {
         // Need to create a new logger
         logger = factory.makeNewLoggerInstance(name, *this);
-        bool inserted = loggerPtrs.emplace (name, logger).second;
+        LoggerTrieNode & node = updateParents(logger);
+        updateChildren(node, logger);
+
+        // Publish the logger for lock-free lookups only after it has been
+        // linked into the hierarchy.
+        bool inserted;
+        {
+            std::unique_lock shard_guard (shard.mtx);
+            inserted = shard.loggers.emplace (name, logger).second;
+        }
         if (! inserted)
         {
             helpers::getLogLog().error(
@@ -296,88 +331,131 @@ Hierarchy::getInstanceImpl(const tstring_view& name,
                 true);
             std::unreachable ();
         }
-
-        if (auto pnm_it = provisionNodes.find(name); pnm_it != provisionNodes.end())
-        {
-            updateChildren(pnm_it->second, logger);
-            provisionNodes.erase(pnm_it);
-        }
-        updateParents(logger);
     }
 
     return logger;
 }
 
 
+Logger
+Hierarchy::findLogger(HashedName const & hn) const
+{
+    LoggerMapShard const & shard = getShard (hn);
+    std::shared_lock shard_guard (shard.mtx);
+
+    if (auto it = shard.loggers.find (hn); it != shard.loggers.end ())
+        return it->second;
+    else
+        return Logger ();
+}
+
+
+Hierarchy::LoggerMapShard &
+Hierarchy::getShard(HashedName const & hn)
+{
+    return loggerPtrs[hn.hash % LOGGER_MAP_SHARDS];
+}
+
+
+Hierarchy::LoggerMapShard const &
+Hierarchy::getShard(HashedName const & hn) const
+{
+    return loggerPtrs[hn.hash % LOGGER_MAP_SHARDS];
+}
+
+
 void
 Hierarchy::initializeLoggerList(LoggerList& list) const
 {
-    list.reserve (list.size () + loggerPtrs.size ());
-    for (auto & kv : loggerPtrs)
-        list.push_back(kv.second);
+    std::size_t count = 0;
+    for (auto const & shard : loggerPtrs)
+        count += shard.loggers.size ();
+
+    list.reserve (list.size () + count);
+    for (auto const & shard : loggerPtrs)
+        for (auto & kv : shard.loggers)
+            list.push_back(kv.second);
 }
 
 
-void
+Hierarchy::LoggerTrieNode &
 Hierarchy::updateParents(Logger const & logger)
 {
-    tstring const & name = logger.getName();
-    auto const length = name.length();
-    bool parentFound = false;
-    tstring substr;
-
-    // if name = "w.x.y.z", loop through "w.x.y", "w.x" and "w", but not "w.x.y.z"
-    for(std::size_t i=name.find_last_of(LOG4CPLUS_TEXT('.'), length-1);
-        i != tstring::npos && i > 0;
-        i = name.find_last_of(LOG4CPLUS_TEXT('.'), i-1))
+    tstring_view const name = logger.getName();
+    spi::LoggerImpl * parent = root.value;
+    LoggerTrieNode * node = loggerTrie;
+
+    // if name = "w.x.y.z", walk through nodes "w", "x", "y" and "z"; the
+    // closest of "w", "w.x" and "w.x.y" that has a logger is the parent
+    for (std::size_t pos = 0; ; )
     {
-        substr.assign (name, 0, i);
+        std::size_t const dot = name.find (LOG4CPLUS_TEXT ('.'), pos);
+        tstring_view const segment = name.substr (pos,
+            dot == tstring_view::npos ? tstring_view::npos : dot - pos);
 
-        if (auto it = loggerPtrs.find(substr); it != loggerPtrs.end())
-        {
-            parentFound = true;
-            logger.value->parent = it->second.value;
-            break;  // no need to update the ancestors of the closest ancestor
-        }
-        else
-        {
-            if (auto it2 = provisionNodes.find(substr); it2 != provisionNodes.end())
-                it2->second.push_back(logger);
-            else
-            {
-                ProvisionNode node;
-                node.push_back(logger);
-                std::pair<ProvisionNodeMap::iterator, bool> tmp =
-                    provisionNodes.emplace (substr, node);
-                if(!tmp.second) {
-                    helpers::getLogLog().error(
-                        LOG4CPLUS_TEXT("Hierarchy::updateParents()- Insert failed"),
-                        true);
-                    std::unreachable ();
-                }
-            }
-        } // end if Logger found
-    } // end for loop
-
-    if(!parentFound) {
-        logger.value->parent = root.value;
+        HashedName const hn (segment);
+        auto it = node->children.find (hn);
+        if (it == node->children.end ())
+            it = node->children.emplace (segment, newTrieNode ()).first;
+        node = it->second;
+
+        if (dot == tstring_view::npos)
+            break;
+
+        if (node->logger)
+            parent = node->logger;
+
+        pos = dot + 1;
     }
+
+    logger.value->parent = parent;
+    node->logger = logger.value;
+    return *node;
 }
 
 
 void
-Hierarchy::updateChildren(ProvisionNode& pn, Logger const & logger)
+Hierarchy::updateChildren(LoggerTrieNode & node, Logger const & logger)
 {
-    for (Logger & c : pn)
+    std::vector<LoggerTrieNode *> pending;
+    for (auto & kv : node.children)
+        pending.push_back (kv.second);
+
+    while (! pending.empty ())
     {
-        // Unless this child already points to a correct (lower) parent,
-        // make logger.parent point to c.parent and c.parent to logger.
-        if( !startsWith(c.value->parent->getName(), logger.getName()) ) {
-            logger.value->parent = c.value->parent;
-            c.value->parent = logger.value;
+        LoggerTrieNode * const n = pending.back ();
+        pending.pop_back ();
+
+        // The nearest logger below the new logger becomes its child. Loggers
+        // further down already point to a correct (lower) parent.
+        if (n->logger)
+        {
+            n->logger->parent = logger.value;
+            n->logger->invalidateDispatchList (false);
         }
+        else
+            for (auto & kv : n->children)
+                pending.push_back (kv.second);
     }
 }
 
 
+Hierarchy::LoggerTrieNode *
+Hierarchy::newTrieNode()
+{
+    return std::pmr::polymorphic_allocator<> (&trieArena)
+        .new_object<LoggerTrieNode> (&trieArena);
+}
+
+
+void
+Hierarchy::resetLoggerTrie()
+{
+    // The nodes only own memory of the arena, so there is no need to run
+    // their destructors, which would have to visit every node.
+    trieArena.release ();
+    loggerTrie = newTrieNode ();
+}
+
+
 } // namespace log4cplus
@@ -49,11 +49,13 @@ formatRelativeTimestamp (log4cplus::tostream & output,
 
 Layout::Layout ()
     : llmCache(getLogLevelManager())
+    , eventFields(spi::EVENT_FIELDS_ALL)
 { }
 
 
 Layout::Layout (const log4cplus::helpers::Properties&)
     : llmCache(getLogLevelManager())
+    , eventFields(spi::EVENT_FIELDS_ALL)
 { }
 
 
@@ -64,12 +66,19 @@ Layout::~Layout() = default;
 // log4cplus::SimpleLayout public methods
 ///////////////////////////////////////////////////////////////////////////////
 
-SimpleLayout::SimpleLayout () = default;
+SimpleLayout::SimpleLayout ()
+{
+    formatKey = LOG4CPLUS_TEXT ("SimpleLayout");
+    eventFields = spi::EVENT_FIELDS_NONE;
+}
 
 
 SimpleLayout::SimpleLayout (const helpers::Properties& properties)
     : Layout (properties)
-{ }
+{
+    formatKey = LOG4CPLUS_TEXT ("SimpleLayout");
+    eventFields = spi::EVENT_FIELDS_NONE;
+}
 
 
 SimpleLayout::~SimpleLayout() = default;
@@ -98,6 +107,10 @@ SimpleLayout::formatAndAppend(log4cplus::tostream& output,
     , category_prefixing (category_prefixing_)
     , context_printing (context_printing_)
 {
+    // Thread and context printing can be switched on later.
+    eventFields = spi::EVENT_FIELD_TIMESTAMP | spi::EVENT_FIELD_THREAD
+        | spi::EVENT_FIELD_NDC;
+    updateFormatKey ();
 }
 
 
@@ -110,6 +123,9 @@ TTCCLayout::TTCCLayout(const log4cplus::helpers::Properties& properties)
     properties.getBool (thread_printing, LOG4CPLUS_TEXT("ThreadPrinting"));
     properties.getBool (category_prefixing, LOG4CPLUS_TEXT("CategoryPrefixing"));
     properties.getBool (context_printing, LOG4CPLUS_TEXT("ContextPrinting"));
+    eventFields = spi::EVENT_FIELD_TIMESTAMP | spi::EVENT_FIELD_THREAD
+        | spi::EVENT_FIELD_NDC;
+    updateFormatKey ();
 }
 
 
@@ -167,6 +183,7 @@ void
 TTCCLayout::setThreadPrinting(bool thread_printing_)
 {
     thread_printing = thread_printing_;
+    updateFormatKey ();
 }
 
 
@@ -181,6 +198,7 @@ void
 TTCCLayout::setCategoryPrefixing(bool category_prefixing_)
 {
     category_prefixing = category_prefixing_;
+    updateFormatKey ();
 }
 
 
@@ -195,6 +213,21 @@ void
 TTCCLayout::setContextPrinting(bool context_printing_)
 {
     context_printing = context_printing_;
+    updateFormatKey ();
+}
+
+
+
+void
+TTCCLayout::updateFormatKey()
+{
+    formatKey = LOG4CPLUS_TEXT ("TTCCLayout ");
+    formatKey += use_gmtime ? LOG4CPLUS_TEXT ('1') : LOG4CPLUS_TEXT ('0');
+    formatKey += thread_printing ? LOG4CPLUS_TEXT ('1') : LOG4CPLUS_TEXT ('0');
+    formatKey += category_prefixing ? LOG4CPLUS_TEXT ('1') : LOG4CPLUS_TEXT ('0');
+    formatKey += context_printing ? LOG4CPLUS_TEXT ('1') : LOG4CPLUS_TEXT ('0');
+    formatKey += LOG4CPLUS_TEXT (' ');
+    formatKey += dateFormat;
 }
 
 
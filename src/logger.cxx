@@ -317,6 +317,20 @@ Logger::getName () const
 }
 
 
+helpers::SharedTString const &
+Logger::getNameHandle () const
+{
+    return value->getNameHandle ();
+}
+
+
+unsigned
+Logger::getEventFields () const
+{
+    return value->getEventFields ();
+}
+
+
 bool
 Logger::getAdditivity () const
 {
@@ -26,6 +26,13 @@
 #include <log4cplus/spi/loggingevent.h>
 #include <log4cplus/spi/rootlogger.h>
 #include <log4cplus/thread/syncprims-pub-impl.h>
+#include <algorithm>
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <log4cplus/layout.h>
+#include <log4cplus/nullappender.h>
+#include <catch_amalgamated.hpp>
+#endif
 
 
 namespace log4cplus::spi {
@@ -34,7 +41,7 @@ namespace log4cplus::spi {
 // Logger Constructors and Destructor
 //////////////////////////////////////////////////////////////////////////////
 LoggerImpl::LoggerImpl(const log4cplus::tstring_view& name_, Hierarchy& h)
-  : name(name_),
+  : name(helpers::internString (name_)),
     ll(NOT_SET_LOG_LEVEL),
     parent(nullptr),
     additive(true),
@@ -53,14 +60,41 @@ LoggerImpl::~LoggerImpl() = default;
 void
 LoggerImpl::callAppenders(const InternalLoggingEvent& event)
 {
-    int writes = 0;
-    for(const LoggerImpl* c = this; c != nullptr; c=c->parent.get()) {
-        writes += c->appendLoopOnAppenders(event);
-        if(!c->additive) {
-            break;
-        }
+    // The dispatch list may be replaced by reconfiguration meanwhile. The
+    // guard keeps it, and through it its appenders, alive until the event
+    // has been dispatched, without touching any shared reference count.
+    // A slow appender only defers destruction of snapshots retired while
+    // it writes.
+    helpers::EpochGuard const epoch_guard;
+    DispatchList const * const dispatch = getDispatchList ();
+    std::size_t const writes = dispatch->appenders.size ();
+
+    // Let appenders with equivalent layouts share formatted output of the
+    // event. Nested dispatches from within appenders do not share.
+    internal::appender_sratch_pad & appender_sp = internal::get_appender_sp ();
+    bool const share_formats = writes > 1
+        && appender_sp.dispatch_event == nullptr;
+    if (share_formats)
+    {
+        appender_sp.dispatch_event = &event;
+        appender_sp.dispatch_formats_count = 0;
     }
 
+    struct dispatch_guard
+    {
+        ~dispatch_guard ()
+        {
+            if (active)
+                sp.dispatch_event = nullptr;
+        }
+
+        internal::appender_sratch_pad & sp;
+        bool active;
+    } const guard {appender_sp, share_formats};
+
+    for (auto const & appender : dispatch->appenders)
+        appender->doAppend(event);
+
     // No appenders in hierarchy, warn user only once.
     if(!hierarchy.emittedNoAppenderWarning && writes == 0) {
         helpers::getLogLog().error(
@@ -122,8 +156,9 @@ LogLevel
 LoggerImpl::getChainedLogLevel() const
 {
     for(const LoggerImpl *c=this; c != nullptr; c=c->parent.get()) {
-        if(c->ll != NOT_SET_LOG_LEVEL) {
-            return c->ll;
+        if(LogLevel const level = c->ll.load (std::memory_order_relaxed);
+            level != NOT_SET_LOG_LEVEL) {
+            return level;
         }
     }
 
@@ -152,6 +187,107 @@ void
 LoggerImpl::setAdditivity(bool additive_)
 {
     additive = additive_;
+    invalidateDispatchList(false);
+}
+
+
+void
+LoggerImpl::addAppender(SharedAppenderPtr newAppender)
+{
+    helpers::AppenderAttachableImpl::addAppender(std::move (newAppender));
+    invalidateDispatchList(false);
+}
+
+
+void
+LoggerImpl::removeAllAppenders()
+{
+    if (! appenderList.load ())
+        return;
+
+    // Drop the cached dispatch list so that it does not keep the removed
+    // appenders alive. A list rebuilt concurrently from the previous
+    // appenders is stale and gets rebuilt on its next use.
+    helpers::AppenderAttachableImpl::removeAllAppenders();
+    invalidateDispatchList(true);
+}
+
+
+void
+LoggerImpl::removeAppender(SharedAppenderPtr appender)
+{
+    helpers::AppenderAttachableImpl::removeAppender(std::move (appender));
+    invalidateDispatchList(true);
+}
+
+
+std::uint64_t
+LoggerImpl::getDispatchGeneration() const
+{
+    std::uint64_t generation = 0;
+    for (const LoggerImpl * c = this; c != nullptr; c = c->parent.get ())
+        generation += c->dispatchGeneration.load (std::memory_order_acquire);
+
+    return generation;
+}
+
+
+void
+LoggerImpl::invalidateDispatchList(bool dropCached)
+{
+    thread::MutexGuard guard (appender_list_mutex);
+
+    dispatchGeneration.fetch_add (1, std::memory_order_acq_rel);
+    if (dropCached)
+        dispatchList.store (nullptr);
+}
+
+
+LoggerImpl::DispatchList const *
+LoggerImpl::getDispatchList()
+{
+    std::uint64_t const generation = getDispatchGeneration ();
+    std::uint64_t const fieldsEpoch = Appender::getEventFieldsEpoch ();
+    DispatchList const * const current = dispatchList.load ();
+    if (current && current->generation == generation
+        && current->fieldsEpoch == fieldsEpoch)
+        return current;
+
+    auto updated = std::make_unique<DispatchList> ();
+    updated->generation = generation;
+    updated->fieldsEpoch = fieldsEpoch;
+    for (const LoggerImpl * c = this; c != nullptr; c = c->parent.get ())
+    {
+        ListType const * const list = c->appenderList.load ();
+        if (list)
+            for (auto const & appender : *list)
+                if (std::find (updated->appenders.begin (),
+                        updated->appenders.end (), appender)
+                    == updated->appenders.end ())
+                    updated->appenders.push_back (appender);
+
+        if (! c->additive)
+            break;
+    }
+
+    updated->eventFields = EVENT_FIELDS_NONE;
+    for (auto const & appender : updated->appenders)
+        updated->eventFields |= appender->getEventFields ();
+
+    // Concurrent rebuilds may race here; any of the results is valid for
+    // `generation`. The caller's guard keeps `result` alive even if it is
+    // replaced right away.
+    DispatchList const * const result = updated.get ();
+    dispatchList.store (std::move (updated));
+    return result;
+}
+
+
+unsigned
+LoggerImpl::getEventFields()
+{
+    helpers::EpochGuard const epoch_guard;
+    return getDispatchList ()->eventFields;
 }
 
 
@@ -164,8 +300,8 @@ LoggerImpl::forcedLog(LogLevel loglevel,
 {
     spi::InternalLoggingEvent & ev = internal::get_ptd ()->forced_log_ev;
     assert (function);
-    ev.setLoggingEvent (this->getName(), loglevel, message, file, line,
-        function);
+    ev.setLoggingEvent (this->getNameHandle(), loglevel, message, file, line,
+        function, getEventFields ());
     callAppenders(ev);
 }
 
@@ -177,4 +313,182 @@ LoggerImpl::forcedLog(spi::InternalLoggingEvent const & ev)
 }
 
 
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+namespace
+{
+
+class CountingAppender
+    : public Appender
+{
+public:
+    CountingAppender ()
+    { }
+
+    virtual ~CountingAppender ()
+    {
+        destructorImpl ();
+    }
+
+    virtual void close ()
+    { }
+
+    int count = 0;
+    bool format = true;
+    tstring text;
+
+protected:
+    virtual void append (const InternalLoggingEvent & ev)
+    {
+        ++count;
+        if (format)
+            text = formatEvent (ev);
+    }
+};
+
+
+class CountingLayout
+    : public Layout
+{
+public:
+    CountingLayout ()
+    {
+        formatKey = LOG4CPLUS_TEXT ("CountingLayout");
+    }
+
+    virtual void formatAndAppend (tostream & output,
+        const InternalLoggingEvent & ev)
+    {
+        ++formats;
+        output << ev.getMessage ();
+    }
+
+    static int formats;
+};
+
+int CountingLayout::formats = 0;
+
+} // namespace
+
+
+CATCH_TEST_CASE ("LoggerImpl", "[logger]")
+{
+    Hierarchy h;
+    Logger root = h.getRoot ();
+    Logger a = h.getInstance (LOG4CPLUS_TEXT ("a"));
+    Logger ab = h.getInstance (LOG4CPLUS_TEXT ("a.b"));
+    helpers::SharedObjectPtr<CountingAppender> app1 (new CountingAppender);
+    helpers::SharedObjectPtr<CountingAppender> app2 (new CountingAppender);
+    InternalLoggingEvent const ev (ab.getName (), ERROR_LOG_LEVEL,
+        LOG4CPLUS_TEXT ("message"), __FILE__, __LINE__);
+
+    CATCH_SECTION ("current loggers are sorted by name")
+    {
+        h.getInstance (LOG4CPLUS_TEXT ("c"));
+        h.getInstance (LOG4CPLUS_TEXT ("b.a"));
+        std::vector<tstring> names;
+        for (Logger const & logger : h.getCurrentLoggers ())
+            names.push_back (logger.getName ());
+        CATCH_REQUIRE (names == std::vector<tstring> {
+            LOG4CPLUS_TEXT ("a"), LOG4CPLUS_TEXT ("a.b"),
+            LOG4CPLUS_TEXT ("b.a"), LOG4CPLUS_TEXT ("c")});
+    }
+
+    CATCH_SECTION ("appender attached twice is called once")
+    {
+        root.addAppender (SharedAppenderPtr (app1.get ()));
+        ab.addAppender (SharedAppenderPtr (app1.get ()));
+        ab.callAppenders (ev);
+        CATCH_REQUIRE (app1->count == 1);
+    }
+
+    CATCH_SECTION ("dispatch list follows changes")
+    {
+        root.addAppender (SharedAppenderPtr (app1.get ()));
+        ab.callAppenders (ev);
+        CATCH_REQUIRE (app1->count == 1);
+
+        a.addAppender (SharedAppenderPtr (app2.get ()));
+        ab.callAppenders (ev);
+        CATCH_REQUIRE (app1->count == 2);
+        CATCH_REQUIRE (app2->count == 1);
+
+        a.setAdditivity (false);
+        ab.callAppenders (ev);
+        CATCH_REQUIRE (app1->count == 2);
+        CATCH_REQUIRE (app2->count == 2);
+
+        // Logger created between "a" and "a.b.c" becomes its parent.
+        Logger abc = h.getInstance (LOG4CPLUS_TEXT ("a.b.c"));
+        abc.callAppenders (ev);
+        CATCH_REQUIRE (app2->count == 3);
+        ab.setAdditivity (false);
+        abc.callAppenders (ev);
+        CATCH_REQUIRE (app2->count == 3);
+        ab.setAdditivity (true);
+
+        a.removeAppender (SharedAppenderPtr (app2.get ()));
+        ab.callAppenders (ev);
+        CATCH_REQUIRE (app2->count == 3);
+    }
+
+    CATCH_SECTION ("equivalent layouts format once")
+    {
+        app1->setLayout (std::make_unique<CountingLayout> ());
+        app2->setLayout (std::make_unique<CountingLayout> ());
+        root.addAppender (SharedAppenderPtr (app1.get ()));
+        a.addAppender (SharedAppenderPtr (app2.get ()));
+
+        CountingLayout::formats = 0;
+        ab.callAppenders (ev);
+        CATCH_REQUIRE (CountingLayout::formats == 1);
+        CATCH_REQUIRE (app1->text == LOG4CPLUS_TEXT ("message"));
+        CATCH_REQUIRE (app2->text == LOG4CPLUS_TEXT ("message"));
+
+        app2->doAppend (ev);
+        CATCH_REQUIRE (CountingLayout::formats == 2);
+    }
+
+    CATCH_SECTION ("concurrent formatting skips appenders that do not format")
+    {
+        app1->setLayout (std::make_unique<CountingLayout> ());
+        app1->setConcurrentFormatting (true);
+        app1->format = false;
+
+        CountingLayout::formats = 0;
+        app1->doAppend (ev);
+        CATCH_REQUIRE (app1->count == 1);
+        CATCH_REQUIRE (CountingLayout::formats == 0);
+    }
+
+    CATCH_SECTION ("event fields")
+    {
+        CATCH_REQUIRE (ab.getEventFields () == EVENT_FIELDS_NONE);
+
+        SharedAppenderPtr null_app (new NullAppender);
+        a.addAppender (null_app);
+        CATCH_REQUIRE (ab.getEventFields () == EVENT_FIELDS_NONE);
+
+        null_app->setLayout (std::make_unique<PatternLayout> (
+            LOG4CPLUS_TEXT ("%d %t %m%n")));
+        CATCH_REQUIRE (ab.getEventFields ()
+            == (EVENT_FIELD_TIMESTAMP | EVENT_FIELD_THREAD));
+
+        null_app->addFilter (FilterPtr (new NDCMatchFilter));
+        CATCH_REQUIRE (ab.getEventFields ()
+            == (EVENT_FIELD_TIMESTAMP | EVENT_FIELD_THREAD | EVENT_FIELD_NDC));
+
+        root.addAppender (SharedAppenderPtr (app1.get ()));
+        CATCH_REQUIRE (ab.getEventFields () == EVENT_FIELDS_ALL);
+
+        InternalLoggingEvent const copy (ev, EVENT_FIELD_THREAD);
+        CATCH_REQUIRE (copy.getThread () == ev.getThread ());
+        CATCH_REQUIRE (copy.getFile ().empty ());
+        CATCH_REQUIRE (copy.getMDCCopy ().empty ());
+    }
+
+    h.shutdown ();
+}
+#endif // LOG4CPLUS_WITH_UNIT_TESTS
+
+
 } // namespace log4cplus::spi
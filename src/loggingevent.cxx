@@ -29,6 +29,28 @@ namespace log4cplus::spi {
 static const int LOG4CPLUS_DEFAULT_TYPE = 1;
 
 
+//! Interned empty string used for events which have no logger name.
+static helpers::SharedTString const &
+get_empty_name ()
+{
+    static helpers::SharedTString const * const empty_name
+        = new helpers::SharedTString (helpers::internString (
+            log4cplus::tstring_view ()));
+    return *empty_name;
+}
+
+
+//! Shared empty MDC used for events which do not capture MDC.
+static SharedMappedDiagnosticContextMap const &
+get_empty_mdc ()
+{
+    static SharedMappedDiagnosticContextMap const * const empty_mdc
+        = new SharedMappedDiagnosticContextMap (
+            std::make_shared<MappedDiagnosticContextMap const> ());
+    return *empty_mdc;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // InternalLoggingEvent ctors and dtor
 ///////////////////////////////////////////////////////////////////////////////
@@ -37,6 +59,16 @@ InternalLoggingEvent::InternalLoggingEvent(
     const log4cplus::tstring_view& logger,
     LogLevel loglevel, const log4cplus::tstring_view& message_,
     const char* filename, int line_, const char * function_)
+    : InternalLoggingEvent (helpers::internString (logger), loglevel,
+        message_, filename, line_, function_)
+{
+}
+
+
+InternalLoggingEvent::InternalLoggingEvent(
+    const helpers::SharedTString& logger,
+    LogLevel loglevel, const log4cplus::tstring_view& message_,
+    const char* filename, int line_, const char * function_)
     : message(message_)
     , loggerName(logger)
     , ll(loglevel)
@@ -67,12 +99,15 @@ InternalLoggingEvent::InternalLoggingEvent(
     const log4cplus::tstring_view& file_, int line_,
     const log4cplus::tstring_view& function_)
     : message(message_)
-    , loggerName(logger)
+    , loggerName(helpers::internString (logger))
     , ll(loglevel)
-    , ndc(ndc_)
-    , mdc(mdc_)
-    , thread(thread_)
-    , thread2(thread2_)
+    , ndc(ndc_.empty ()
+        ? SharedDiagnosticContextFrame ()
+        : std::make_shared<DiagnosticContextFrame const> (
+            log4cplus::tstring (ndc_), SharedDiagnosticContextFrame ()))
+    , mdc(std::make_shared<MappedDiagnosticContextMap const> (mdc_))
+    , thread(helpers::internString (thread_))
+    , thread2(helpers::internString (thread2_))
     , timestamp(time)
     , file(file_)
     , function (function_.data ()
@@ -88,7 +123,8 @@ InternalLoggingEvent::InternalLoggingEvent(
 
 
 InternalLoggingEvent::InternalLoggingEvent ()
-    : ll (NOT_SET_LOG_LEVEL)
+    : loggerName (get_empty_name ())
+    , ll (NOT_SET_LOG_LEVEL)
     , line (0)
     , threadCached(false)
     , thread2Cached(false)
@@ -100,12 +136,12 @@ InternalLoggingEvent::InternalLoggingEvent ()
 InternalLoggingEvent::InternalLoggingEvent(
     const log4cplus::spi::InternalLoggingEvent& rhs)
     : message(rhs.getMessage())
-    , loggerName(rhs.getLoggerName())
+    , loggerName(rhs.getLoggerNameHandle())
     , ll(rhs.getLogLevel())
-    , ndc(rhs.getNDC())
-    , mdc(rhs.getMDCCopy())
-    , thread(rhs.getThread())
-    , thread2(rhs.getThread2())
+    , ndc(rhs.getNDCSnapshot())
+    , mdc(rhs.getMDCSnapshot())
+    , thread(rhs.getThreadHandle())
+    , thread2(rhs.getThread2Handle())
     , timestamp(rhs.getTimestamp())
     , file(rhs.getFile())
     , function(rhs.getFunction())
@@ -118,6 +154,39 @@ InternalLoggingEvent::InternalLoggingEvent(
 }
 
 
+InternalLoggingEvent::InternalLoggingEvent(
+    const log4cplus::spi::InternalLoggingEvent& rhs, unsigned fields)
+    : message(rhs.getMessage())
+    , loggerName(rhs.getLoggerNameHandle())
+    , ll(rhs.getLogLevel())
+    , timestamp(rhs.getTimestamp())
+    , line(rhs.getLine())
+    , threadCached(true)
+    , thread2Cached(true)
+    , ndcCached(true)
+    , mdcCached(true)
+{
+    if (fields & EVENT_FIELD_LOCATION)
+    {
+        file = rhs.getFile ();
+        function = rhs.getFunction ();
+    }
+
+    if (fields & EVENT_FIELD_NDC)
+        ndc = rhs.getNDCSnapshot ();
+
+    if (fields & EVENT_FIELD_MDC)
+        mdc = rhs.getMDCSnapshot ();
+    else
+        mdc = get_empty_mdc ();
+
+    thread = (fields & EVENT_FIELD_THREAD)
+        ? rhs.getThreadHandle () : get_empty_name ();
+    thread2 = (fields & EVENT_FIELD_THREAD2)
+        ? rhs.getThread2Handle () : get_empty_name ();
+}
+
+
 InternalLoggingEvent::~InternalLoggingEvent() = default;
 
 
@@ -142,6 +211,23 @@ void
 InternalLoggingEvent::setLoggingEvent (const log4cplus::tstring_view & logger,
     LogLevel loglevel, const log4cplus::tstring_view & msg,
     const char * filename, int fline, const char * function_)
+{
+    // Avoid the interning table if the name has not changed since the
+    // previous use of this event.
+    if (! loggerName || *loggerName != logger)
+        setLoggingEvent (helpers::internString (logger), loglevel, msg,
+            filename, fline, function_);
+    else
+        setLoggingEvent (helpers::SharedTString (loggerName), loglevel, msg,
+            filename, fline, function_);
+}
+
+
+void
+InternalLoggingEvent::setLoggingEvent (const helpers::SharedTString & logger,
+    LogLevel loglevel, const log4cplus::tstring_view & msg,
+    const char * filename, int fline, const char * function_,
+    unsigned fields)
 {
     // This could be implemented using the swap idiom:
     //
@@ -153,14 +239,18 @@ InternalLoggingEvent::setLoggingEvent (const log4cplus::tstring_view & logger,
     loggerName = logger;
     ll = loglevel;
     message = msg;
-    timestamp = helpers::now ();
 
-    if (filename)
+    if (fields & EVENT_FIELD_TIMESTAMP)
+        timestamp = helpers::now ();
+    else
+        timestamp = helpers::Time ();
+
+    if (filename && (fields & EVENT_FIELD_LOCATION))
         file = LOG4CPLUS_C_STR_TO_TSTRING (filename);
     else
         file.clear ();
 
-    if (function_)
+    if (function_ && (fields & EVENT_FIELD_LOCATION))
         function = LOG4CPLUS_C_STR_TO_TSTRING (function_);
     else
         function.clear ();
@@ -216,6 +306,41 @@ InternalLoggingEvent::clone() const
 }
 
 
+helpers::SharedTString const &
+InternalLoggingEvent::getThreadHandle() const
+{
+    if (! threadCached)
+    {
+        thread = internal::get_thread_name_handle ();
+        threadCached = true;
+    }
+    return thread;
+}
+
+
+helpers::SharedTString const &
+InternalLoggingEvent::getThread2Handle() const
+{
+    if (! thread2Cached)
+    {
+        thread2 = internal::get_thread_name2_handle ();
+        thread2Cached = true;
+    }
+    return thread2;
+}
+
+
+const log4cplus::tstring&
+InternalLoggingEvent::getNDC() const
+{
+    SharedDiagnosticContextFrame const & frame = getNDCSnapshot ();
+    if (frame)
+        return frame->getFullMessage ();
+    else
+        return internal::empty_str;
+}
+
+
 tstring const &
 InternalLoggingEvent::getMDC (tstring const & key) const
 {
@@ -237,12 +362,16 @@ InternalLoggingEvent::operator = (const InternalLoggingEvent& rhs)
 
 
 void
-InternalLoggingEvent::gatherThreadSpecificData () const
+InternalLoggingEvent::gatherThreadSpecificData (unsigned fields) const
 {
-    getNDC ();
-    getMDCCopy ();
-    getThread ();
-    getThread2 ();
+    if (fields & EVENT_FIELD_NDC)
+        getNDCSnapshot ();
+    if (fields & EVENT_FIELD_MDC)
+        getMDCSnapshot ();
+    if (fields & EVENT_FIELD_THREAD)
+        getThreadHandle ();
+    if (fields & EVENT_FIELD_THREAD2)
+        getThread2Handle ();
 }
 
 
@@ -265,6 +394,7 @@ InternalLoggingEvent::swap (InternalLoggingEvent & other)
     swap (threadCached, other.threadCached);
     swap (thread2Cached, other.thread2Cached);
     swap (ndcCached, other.ndcCached);
+    swap (mdcCached, other.mdcCached);
 }
 
 
@@ -95,8 +95,8 @@ macro_forced_log (log4cplus::Logger const & logger,
 {
     log4cplus::spi::InternalLoggingEvent & ev
         = internal::get_ptd ()->forced_log_ev;
-    ev.setLoggingEvent (logger.getName (), log_level, msg, filename, line,
-        func);
+    ev.setLoggingEvent (logger.getNameHandle (), log_level, msg, filename,
+        line, func, logger.getEventFields ());
     logger.forcedLog (ev);
 }
 
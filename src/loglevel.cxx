@@ -21,9 +21,17 @@
 #include <log4cplus/loglevel.h>
 #include <log4cplus/helpers/loglog.h>
 #include <log4cplus/helpers/stringhelper.h>
+#include <log4cplus/helpers/snapshot.h>
 #include <log4cplus/internal/internal.h>
 #include <log4cplus/internal/customloglevelmanager.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <catch_amalgamated.hpp>
+#endif
 
 
 namespace log4cplus
@@ -40,16 +48,30 @@ LogLevelTranslator::~LogLevelTranslator () = default;
 namespace
 {
 
-static tstring const ALL_STRING (LOG4CPLUS_TEXT("ALL"));
-static tstring const TRACE_STRING (LOG4CPLUS_TEXT("TRACE"));
-static tstring const DEBUG_STRING (LOG4CPLUS_TEXT("DEBUG"));
-static tstring const INFO_STRING (LOG4CPLUS_TEXT("INFO"));
-static tstring const WARN_STRING (LOG4CPLUS_TEXT("WARN"));
-static tstring const ERROR_STRING (LOG4CPLUS_TEXT("ERROR"));
-static tstring const FATAL_STRING (LOG4CPLUS_TEXT("FATAL"));
-static tstring const OFF_STRING (LOG4CPLUS_TEXT("OFF"));
-static tstring const NOTSET_STRING (LOG4CPLUS_TEXT("NOTSET"));
-static tstring const UNKNOWN_STRING (LOG4CPLUS_TEXT("UNKNOWN"));
+//! Names of the predefined log levels. They are initialized on first use
+//! because LogLevelManager can build its lookup table during static
+//! initialization.
+struct log_level_names
+{
+    tstring const ALL_STRING {LOG4CPLUS_TEXT("ALL")};
+    tstring const TRACE_STRING {LOG4CPLUS_TEXT("TRACE")};
+    tstring const DEBUG_STRING {LOG4CPLUS_TEXT("DEBUG")};
+    tstring const INFO_STRING {LOG4CPLUS_TEXT("INFO")};
+    tstring const WARN_STRING {LOG4CPLUS_TEXT("WARN")};
+    tstring const ERROR_STRING {LOG4CPLUS_TEXT("ERROR")};
+    tstring const FATAL_STRING {LOG4CPLUS_TEXT("FATAL")};
+    tstring const OFF_STRING {LOG4CPLUS_TEXT("OFF")};
+    tstring const NOTSET_STRING {LOG4CPLUS_TEXT("NOTSET")};
+    tstring const UNKNOWN_STRING {LOG4CPLUS_TEXT("UNKNOWN")};
+};
+
+
+log_level_names const &
+get_names ()
+{
+    static log_level_names const names;
+    return names;
+}
 
 
 class LOG4CPLUS_PRIVATE DefaultLogLevelTranslator
@@ -63,16 +85,17 @@ public:
     log4cplus::tstring const &
     toString (LogLevel ll) const override
     {
+        log_level_names const & n = get_names ();
         switch(ll) {
-        case OFF_LOG_LEVEL:     return OFF_STRING;
-        case FATAL_LOG_LEVEL:   return FATAL_STRING;
-        case ERROR_LOG_LEVEL:   return ERROR_STRING;
-        case WARN_LOG_LEVEL:    return WARN_STRING;
-        case INFO_LOG_LEVEL:    return INFO_STRING;
-        case DEBUG_LOG_LEVEL:   return DEBUG_STRING;
-        case TRACE_LOG_LEVEL:   return TRACE_STRING;
-        //case ALL_LOG_LEVEL:     return ALL_STRING;
-        case NOT_SET_LOG_LEVEL: return NOTSET_STRING;
+        case OFF_LOG_LEVEL:     return n.OFF_STRING;
+        case FATAL_LOG_LEVEL:   return n.FATAL_STRING;
+        case ERROR_LOG_LEVEL:   return n.ERROR_STRING;
+        case WARN_LOG_LEVEL:    return n.WARN_STRING;
+        case INFO_LOG_LEVEL:    return n.INFO_STRING;
+        case DEBUG_LOG_LEVEL:   return n.DEBUG_STRING;
+        case TRACE_LOG_LEVEL:   return n.TRACE_STRING;
+        //case ALL_LOG_LEVEL:     return n.ALL_STRING;
+        case NOT_SET_LOG_LEVEL: return n.NOTSET_STRING;
         }
 
         return internal::empty_str;
@@ -84,11 +107,12 @@ public:
         // Since C++11, accessing str[0] is always safe as it returns '\0' for
         // empty string.
 
+        log_level_names const & n = get_names ();
         switch (s[0])
         {
 #define DEF_LLMATCH(_chr, _logLevel)                 \
         case LOG4CPLUS_TEXT (_chr):                  \
-            if (s == _logLevel ## _STRING)           \
+            if (s == n._logLevel ## _STRING)         \
                 return _logLevel ## _LOG_LEVEL;      \
             else                                     \
                 break;
@@ -144,9 +168,133 @@ protected:
     log4cplus::tstring name;
 };
 
+//! Returns name of `ll` given by the first translator that knows it.
+tstring const &
+translate (std::vector<SharedLogLevelTranslatorPtr> const & translators,
+    LogLevel ll)
+{
+    for (auto & ptr : translators)
+    {
+        tstring const & ret = ptr->toString (ll);
+        if (! ret.empty ())
+            return ret;
+    }
+
+    return get_names ().UNKNOWN_STRING;
+}
+
 } // namespace
 
 
+//! Names of log levels, filled in as they are looked up. Levels
+//! NOT_SET_LOG_LEVEL through OFF_LOG_LEVEL are kept in pages of 256
+//! levels allocated on first use, other levels in a map. The table
+//! owns copies of the names, so that they outlive changes of the
+//! translators.
+struct LogLevelManager::LookupTable
+{
+    static constexpr LogLevel MIN_LEVEL = NOT_SET_LOG_LEVEL;
+    static constexpr LogLevel MAX_LEVEL = OFF_LOG_LEVEL;
+    static constexpr std::size_t LEVELS
+        = static_cast<std::size_t> (MAX_LEVEL - MIN_LEVEL) + 1;
+    static constexpr std::size_t PAGE_BITS = 8;
+    static constexpr std::size_t PAGE_SIZE = std::size_t (1) << PAGE_BITS;
+    static constexpr std::size_t PAGES
+        = (LEVELS + PAGE_SIZE - 1) >> PAGE_BITS;
+
+    //! Null entries have not been looked up yet.
+    typedef std::array<std::atomic<tstring const *>, PAGE_SIZE> Page;
+
+    explicit LookupTable (LogLevelTranslatorList const & translators_)
+        : translators (translators_)
+    { }
+
+    ~LookupTable ()
+    {
+        for (auto & page_ptr : pages)
+            if (Page * page = page_ptr.load (std::memory_order_relaxed))
+            {
+                for (auto & entry : *page)
+                    releaseName (entry.load (std::memory_order_relaxed));
+                delete page;
+            }
+    }
+
+    //! Looks `ll` up through the translators and caches the name.
+    tstring const & fill (std::atomic<tstring const *> & entry, LogLevel ll)
+    {
+        tstring const * name = copyName (ll);
+        tstring const * expected = nullptr;
+        if (! entry.compare_exchange_strong (expected, name,
+                std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            // Another thread has been faster.
+            releaseName (name);
+            name = expected;
+        }
+
+        return *name;
+    }
+
+    std::atomic<tstring const *> & getEntry (std::size_t index)
+    {
+        std::atomic<Page *> & page_ptr = pages[index >> PAGE_BITS];
+        Page * page = page_ptr.load (std::memory_order_acquire);
+        if (! page)
+        {
+            auto new_page = std::make_unique<Page> ();
+            if (page_ptr.compare_exchange_strong (page, new_page.get (),
+                    std::memory_order_acq_rel, std::memory_order_acquire))
+                page = new_page.release ();
+        }
+
+        return (*page)[index & (PAGE_SIZE - 1)];
+    }
+
+    tstring const & lookupOther (LogLevel ll)
+    {
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+        std::lock_guard guard (otherMtx);
+#endif
+        auto it = others.find (ll);
+        if (it == others.end ())
+        {
+            helpers::EpochGuard const epoch_guard;
+            it = others.emplace (ll, translate (translators, ll)).first;
+        }
+
+        return it->second;
+    }
+
+    LogLevelTranslatorList const translators;
+    std::array<std::atomic<Page *>, PAGES> pages {};
+
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    std::mutex otherMtx;
+#endif
+    std::map<LogLevel, tstring> others;
+
+private:
+    tstring const * copyName (LogLevel ll) const
+    {
+        // Translators free removed names only after readers holding an
+        // EpochGuard are gone, see CustomLogLevelManager::remove().
+        helpers::EpochGuard const epoch_guard;
+        tstring const & name = translate (translators, ll);
+        if (&name == &get_names ().UNKNOWN_STRING)
+            return &name;
+        else
+            return new tstring (name);
+    }
+
+    static void releaseName (tstring const * name)
+    {
+        if (name != &get_names ().UNKNOWN_STRING)
+            delete name;
+    }
+};
+
+
 
 //////////////////////////////////////////////////////////////////////////////
 // LogLevelManager ctors and dtor
@@ -169,18 +317,19 @@ LogLevelManager::~LogLevelManager() = default;
 tstring const &
 LogLevelManager::toString(LogLevel ll) const
 {
-#if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    std::shared_lock guard (mtx);
-#endif
+    LookupTable * const t = table.load (std::memory_order_acquire);
 
-    for (auto & ptr : translator_list)
+    if (ll >= LookupTable::MIN_LEVEL && ll <= LookupTable::MAX_LEVEL)
     {
-        tstring const & ret = ptr->toString (ll);
-        if (! ret.empty ())
-            return ret;
+        std::atomic<tstring const *> & entry = t->getEntry (
+            static_cast<std::size_t> (ll - LookupTable::MIN_LEVEL));
+        if (tstring const * name = entry.load (std::memory_order_acquire))
+            return *name;
+        else
+            return t->fill (entry, ll);
     }
-
-    return UNKNOWN_STRING;
+    else
+        return t->lookupOther (ll);
 }
 
 
@@ -190,7 +339,7 @@ LogLevelManager::fromString(const tstring_view& arg) const
     tstring const s = helpers::toUpper(arg);
 
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    std::shared_lock guard (mtx);
+    std::lock_guard guard (mtx);
 #endif
 
     for (auto & ptr : translator_list)
@@ -230,11 +379,75 @@ LogLevelManager::pushLogLevelTranslator(SharedLogLevelTranslatorPtr translator)
             true);
 
 #if ! defined (LOG4CPLUS_SINGLE_THREADED)
-    std::unique_lock guard (mtx);
+    std::lock_guard guard (mtx);
 #endif
 
     translator_list.push_back (std::move (translator));
+    rebuildLookupTable ();
+}
+
+
+void
+LogLevelManager::reloadLogLevelTranslators()
+{
+#if ! defined (LOG4CPLUS_SINGLE_THREADED)
+    std::lock_guard guard (mtx);
+#endif
+
+    rebuildLookupTable ();
+}
+
+
+void
+LogLevelManager::rebuildLookupTable()
+{
+    // Readers can still be using the current table, it is kept in
+    // `tables` until destruction.
+    tables.push_back (std::make_unique<LookupTable> (translator_list));
+    table.store (tables.back ().get (), std::memory_order_release);
+}
+
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+CATCH_TEST_CASE ("LogLevelManager", "[loglevel]")
+{
+    LogLevelManager llm;
+
+    CATCH_SECTION ("default levels")
+    {
+        CATCH_REQUIRE (llm.toString (NOT_SET_LOG_LEVEL)
+            == LOG4CPLUS_TEXT ("NOTSET"));
+        CATCH_REQUIRE (llm.toString (TRACE_LOG_LEVEL)
+            == LOG4CPLUS_TEXT ("TRACE"));
+        CATCH_REQUIRE (llm.toString (OFF_LOG_LEVEL) == LOG4CPLUS_TEXT ("OFF"));
+        CATCH_REQUIRE (llm.toString (1) == LOG4CPLUS_TEXT ("UNKNOWN"));
+        CATCH_REQUIRE (llm.toString (-2) == LOG4CPLUS_TEXT ("UNKNOWN"));
+    }
+
+    CATCH_SECTION ("pushed levels")
+    {
+        llm.pushLogLevel (45000, LOG4CPLUS_TEXT ("CRITICAL"));
+        llm.pushLogLevel (70000, LOG4CPLUS_TEXT ("BEYOND"));
+        CATCH_REQUIRE (llm.toString (45000) == LOG4CPLUS_TEXT ("CRITICAL"));
+        CATCH_REQUIRE (llm.toString (45001) == LOG4CPLUS_TEXT ("UNKNOWN"));
+        CATCH_REQUIRE (llm.toString (70000) == LOG4CPLUS_TEXT ("BEYOND"));
+        CATCH_REQUIRE (llm.toString (ERROR_LOG_LEVEL)
+            == LOG4CPLUS_TEXT ("ERROR"));
+        CATCH_REQUIRE (llm.fromString (LOG4CPLUS_TEXT ("critical")) == 45000);
+    }
+
+    CATCH_SECTION ("names outlive table rebuilds")
+    {
+        llm.pushLogLevel (45000, LOG4CPLUS_TEXT ("CRITICAL"));
+        tstring const & critical = llm.toString (45000);
+        tstring const & beyond = llm.toString (70000);
+        llm.pushLogLevel (70000, LOG4CPLUS_TEXT ("BEYOND"));
+        CATCH_REQUIRE (critical == LOG4CPLUS_TEXT ("CRITICAL"));
+        CATCH_REQUIRE (beyond == LOG4CPLUS_TEXT ("UNKNOWN"));
+        CATCH_REQUIRE (llm.toString (70000) == LOG4CPLUS_TEXT ("BEYOND"));
+    }
 }
+#endif // LOG4CPLUS_WITH_UNIT_TESTS
 
 
 } // namespace log4cplus
@@ -21,6 +21,7 @@
 //  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
 //  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <atomic>
 #include <utility>
 #include <memory>
 #include <type_traits>
@@ -35,11 +36,31 @@
 namespace log4cplus
 {
 
+namespace
+{
+
+//! Returns true if `map` is not shared with any snapshot. The acquire
+//! fence pairs with the release of the last snapshot by another thread,
+//! so that its reads of the map happen before modifications in place.
+bool
+is_exclusive (std::shared_ptr<MappedDiagnosticContextMap> const & map)
+{
+    if (map.use_count () != 1)
+        return false;
+
+    std::atomic_thread_fence (std::memory_order_acquire);
+    return true;
+}
+
+} // namespace
+
+
 //
 // MappedDiagnosticContext
 //
 
 MappedDiagnosticContext::MappedDiagnosticContext ()
+    : context_map (std::make_shared<MappedDiagnosticContextMap> ())
 { }
 
 
@@ -51,7 +72,23 @@ void
 MappedDiagnosticContext::clear ()
 {
     stacks_map.clear ();
-    context_map.clear ();
+    if (is_exclusive (context_map))
+        context_map->clear ();
+    else
+        context_map = std::make_shared<MappedDiagnosticContextMap> ();
+}
+
+
+MappedDiagnosticContextMap &
+MappedDiagnosticContext::getWritableContextMap ()
+{
+    // Only this thread hands out snapshots of the map, so it cannot become
+    // shared while it is being modified here.
+    if (! is_exclusive (context_map))
+        context_map = std::make_shared<MappedDiagnosticContextMap> (
+            *context_map);
+
+    return *context_map;
 }
 
 
@@ -86,8 +123,11 @@ auto
 insert_or_assign (Map & map, Key && key, Value && value)
 -> std::optional<typename Map::mapped_type>
 {
+    using KeyType = typename Map::key_type;
     using ValueType = typename Map::mapped_type;
-    auto [it, inserted] = map.emplace (std::forward<Key>(key),
+    // Unlike emplace(), try_emplace() leaves `value` alone when the key
+    // is already present.
+    auto [it, inserted] = map.try_emplace (KeyType (std::forward<Key>(key)),
         std::forward<Value> (value));
     if (inserted)
         return std::optional<ValueType> ();
@@ -104,7 +144,7 @@ insert_or_assign (Map & map, Key && key, Value && value)
 void
 MDC::put (tstring_view const & key, tstring const & value)
 {
-    MappedDiagnosticContextMap & mdc_map = getPtr ()->context_map;
+    MappedDiagnosticContextMap & mdc_map = getPtr ()->getWritableContextMap ();
     insert_or_assign (mdc_map, key, value);
 }
 
@@ -112,7 +152,7 @@ MDC::put (tstring_view const & key, tstring const & value)
 void
 MDC::put (tstring_view const & key, tstring && value)
 {
-    MappedDiagnosticContextMap & mdc_map = getPtr ()->context_map;
+    MappedDiagnosticContextMap & mdc_map = getPtr ()->getWritableContextMap ();
     insert_or_assign (mdc_map, key, std::move (value));
 }
 
@@ -143,7 +183,7 @@ MDC::push (tstring_view const & key, tstring && value)
 {
     MappedDiagnosticContext & mdc = *getPtr ();
 
-    MappedDiagnosticContextMap & mdc_map = mdc.context_map;
+    MappedDiagnosticContextMap & mdc_map = mdc.getWritableContextMap ();
     auto opt_prev {insert_or_assign (mdc_map, key, std::move (value))};
 
     if (opt_prev.has_value ())
@@ -159,7 +199,7 @@ MDC::push (tstring_view const & key, tstring_view const & value)
 {
     MappedDiagnosticContext & mdc = *getPtr ();
 
-    MappedDiagnosticContextMap & mdc_map = mdc.context_map;
+    MappedDiagnosticContextMap & mdc_map = mdc.getWritableContextMap ();
     auto opt_prev {insert_or_assign (mdc_map, key, value)};
 
     if (opt_prev.has_value ())
@@ -175,7 +215,7 @@ MDC::pop (tstring const & key)
 {
     MappedDiagnosticContext & mdc = *getPtr ();
 
-    MappedDiagnosticContextMap & mdc_map = mdc.context_map;
+    MappedDiagnosticContextMap & mdc_map = mdc.getWritableContextMap ();
     MappedDiagnosticContextStacksMap & stacks_map = mdc.stacks_map;
     auto it = stacks_map.find (key);
     if (it != stacks_map.end ())
@@ -196,7 +236,7 @@ MDC::pop (tstring const & key)
 std::optional<tstring>
 MDC::get (tstring_view const & key) const
 {
-    MappedDiagnosticContextMap const & dc = getPtr ()->context_map;
+    MappedDiagnosticContextMap const & dc = *getPtr ()->context_map;
     auto it = dc.find (key);
     if (it != dc.end ())
         return std::optional<tstring> (it->second);
@@ -208,13 +248,21 @@ MDC::get (tstring_view const & key) const
 void
 MDC::remove (tstring const & key)
 {
-    MappedDiagnosticContextMap & dc = getPtr ()->context_map;
-    dc.erase (key);
+    MappedDiagnosticContext & mdc = *getPtr ();
+    if (mdc.context_map->find (key) != mdc.context_map->end ())
+        mdc.getWritableContextMap ().erase (key);
 }
 
 
 MappedDiagnosticContextMap const &
 MDC::getContext () const
+{
+    return *getPtr ()->context_map;
+}
+
+
+SharedMappedDiagnosticContextMap
+MDC::getContextSnapshot () const
 {
     return getPtr ()->context_map;
 }
@@ -347,12 +395,31 @@ CATCH_TEST_CASE ("MDC", "[MDC]")
         CATCH_REQUIRE (std::find (stack.begin (), stack.end (), value2) != stack.end ());
     }
 
+    CATCH_SECTION ("snapshot")
+    {
+        SharedMappedDiagnosticContextMap const snapshot
+            = mdc.getContextSnapshot ();
+        CATCH_REQUIRE (snapshot.get () == context_map.get ());
+
+        mdc.put (LOG4CPLUS_TEXT ("key1"), LOG4CPLUS_TEXT ("value3"));
+        CATCH_REQUIRE (snapshot.get () != context_map.get ());
+        CATCH_REQUIRE (snapshot->at (LOG4CPLUS_TEXT ("key1"))
+            == LOG4CPLUS_TEXT ("value1"));
+        CATCH_REQUIRE (*mdc.get (LOG4CPLUS_TEXT ("key1"))
+            == LOG4CPLUS_TEXT ("value3"));
+
+        // Once the snapshot is released, the map is modified in place.
+        auto const * const current = context_map.get ();
+        mdc.put (LOG4CPLUS_TEXT ("key2"), LOG4CPLUS_TEXT ("value4"));
+        CATCH_REQUIRE (context_map.get () == current);
+    }
+
     CATCH_SECTION ("MDCGuard")
     {
         {
             mdc.clear ();
             CATCH_REQUIRE (stacks_map.empty ());
-            CATCH_REQUIRE (context_map.empty ());
+            CATCH_REQUIRE (context_map->empty ());
 
             CATCH_REQUIRE (! mdc.get (LOG4CPLUS_TEXT ("a")).has_value ());
             {
@@ -361,7 +428,7 @@ CATCH_TEST_CASE ("MDC", "[MDC]")
                 CATCH_REQUIRE (*opt_str == LOG4CPLUS_TEXT ("value1"));
 
                 CATCH_REQUIRE (stacks_map.size () == 0);
-                CATCH_REQUIRE (context_map.size () == 1);
+                CATCH_REQUIRE (context_map->size () == 1);
 
                 {
                     CATCH_REQUIRE (value2 != LOG4CPLUS_TEXT ("value1"));
@@ -370,7 +437,7 @@ CATCH_TEST_CASE ("MDC", "[MDC]")
                     CATCH_REQUIRE (stacks_map.size () == 1);
                     CATCH_REQUIRE (stacks_map[LOG4CPLUS_TEXT ("a")].size () == 1);
                     CATCH_REQUIRE (stacks_map[LOG4CPLUS_TEXT ("a")][0] == value1);
-                    CATCH_REQUIRE (context_map.size () == 1);
+                    CATCH_REQUIRE (context_map->size () == 1);
 
                     CATCH_REQUIRE ((opt_str = mdc.get (LOG4CPLUS_TEXT ("a"))).has_value ());
                     CATCH_REQUIRE (*opt_str == value2);
@@ -378,7 +445,7 @@ CATCH_TEST_CASE ("MDC", "[MDC]")
 
                 CATCH_REQUIRE (stacks_map.size () == 1);
                 CATCH_REQUIRE (stacks_map[LOG4CPLUS_TEXT ("a")].empty ());
-                CATCH_REQUIRE (context_map.size () == 1);
+                CATCH_REQUIRE (context_map->size () == 1);
 
                 CATCH_REQUIRE ((opt_str = mdc.get (LOG4CPLUS_TEXT ("a"))).has_value ());
                 CATCH_REQUIRE (*opt_str == LOG4CPLUS_TEXT ("value1"));
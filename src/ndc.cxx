@@ -126,6 +126,41 @@ DiagnosticContext::swap (DiagnosticContext & other)
     swap (fullMessage, other.fullMessage);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// log4cplus::DiagnosticContextFrame
+///////////////////////////////////////////////////////////////////////////////
+
+DiagnosticContextFrame::DiagnosticContextFrame (log4cplus::tstring message_,
+    SharedDiagnosticContextFrame parent_)
+    : message (std::move (message_))
+    , parent (std::move (parent_))
+    , depth (parent ? parent->depth + 1 : 1)
+{ }
+
+
+DiagnosticContextFrame::~DiagnosticContextFrame () = default;
+
+
+log4cplus::tstring const &
+DiagnosticContextFrame::getFullMessage () const
+{
+    if (! parent)
+        return message;
+
+    std::call_once (fullMessageFlag,
+        [this]
+        {
+            log4cplus::tstring const & parentMessage
+                = parent->getFullMessage ();
+            fullMessage.reserve (parentMessage.size () + 1 + message.size ());
+            fullMessage = parentMessage;
+            fullMessage += LOG4CPLUS_TEXT(" ");
+            fullMessage += message;
+        });
+    return fullMessage;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // log4cplus::NDC ctor and dtor
 ///////////////////////////////////////////////////////////////////////////////
@@ -146,8 +181,7 @@ NDC::~NDC()
 void
 NDC::clear()
 {
-    DiagnosticContextStack* ptr = getPtr();
-    DiagnosticContextStack ().swap (*ptr);
+    getPtr()->reset();
 }
 
 
@@ -161,25 +195,51 @@ NDC::remove()
 DiagnosticContextStack
 NDC::cloneStack() const
 {
-    DiagnosticContextStack* ptr = getPtr();
-    return DiagnosticContextStack(*ptr);
+    DiagnosticContextStack stack;
+    for (DiagnosticContextFrame const * frame = getPtr()->get(); frame;
+         frame = frame->getParent().get())
+    {
+        DiagnosticContext dc (frame->getMessage());
+        dc.fullMessage = frame->getFullMessage();
+        stack.push_front (std::move (dc));
+    }
+
+    return stack;
 }
 
 
 void
 NDC::inherit(const DiagnosticContextStack& stack)
 {
-    DiagnosticContextStack* ptr = getPtr();
-    DiagnosticContextStack (stack).swap (*ptr);
+    SharedDiagnosticContextFrame top;
+    for (DiagnosticContext const & dc : stack)
+        top = std::make_shared<DiagnosticContextFrame const> (dc.message,
+            std::move (top));
+
+    *getPtr() = std::move (top);
+}
+
+
+SharedDiagnosticContextFrame
+NDC::getSnapshot() const
+{
+    return *getPtr();
+}
+
+
+void
+NDC::inherit(SharedDiagnosticContextFrame const & snapshot)
+{
+    *getPtr() = snapshot;
 }
 
 
 log4cplus::tstring const &
 NDC::get() const
 {
-    DiagnosticContextStack* ptr = getPtr();
-    if(!ptr->empty())
-        return ptr->back().fullMessage;
+    SharedDiagnosticContextFrame const & top = *getPtr();
+    if (top)
+        return top->getFullMessage();
     else
         return internal::empty_str;
 }
@@ -188,21 +248,20 @@ NDC::get() const
 std::size_t
 NDC::getDepth() const
 {
-    DiagnosticContextStack* ptr = getPtr();
-    return ptr->size();
+    SharedDiagnosticContextFrame const & top = *getPtr();
+    return top ? top->getDepth() : 0;
 }
 
 
 log4cplus::tstring
 NDC::pop()
 {
-    DiagnosticContextStack* ptr = getPtr();
-    if(!ptr->empty())
+    SharedDiagnosticContextFrame & top = *getPtr();
+    if (top)
     {
-        tstring message;
-        message.swap (ptr->back ().message);
-        ptr->pop_back();
-        return message;
+        SharedDiagnosticContextFrame const popped = std::move (top);
+        top = popped->getParent();
+        return popped->getMessage();
     }
     else
         return log4cplus::tstring ();
@@ -212,18 +271,18 @@ NDC::pop()
 void
 NDC::pop_void ()
 {
-    DiagnosticContextStack* ptr = getPtr ();
-    if (! ptr->empty ())
-        ptr->pop_back ();
+    SharedDiagnosticContextFrame & top = *getPtr();
+    if (top)
+        top = SharedDiagnosticContextFrame (top->getParent());
 }
 
 
 log4cplus::tstring const &
 NDC::peek() const
 {
-    DiagnosticContextStack* ptr = getPtr();
-    if(!ptr->empty())
-        return ptr->back().message;
+    SharedDiagnosticContextFrame const & top = *getPtr();
+    if (top)
+        return top->getMessage();
     else
         return internal::empty_str;
 }
@@ -232,42 +291,31 @@ NDC::peek() const
 void
 NDC::push(const log4cplus::tstring& message)
 {
-    push_worker (message);
+    SharedDiagnosticContextFrame & top = *getPtr();
+    top = std::make_shared<DiagnosticContextFrame const> (message,
+        std::move (top));
 }
 
 
 void
 NDC::push(tchar const * message)
 {
-    push_worker (message);
-}
-
-
-template <typename StringType>
-void
-NDC::push_worker (StringType const & message)
-{
-    DiagnosticContextStack* ptr = getPtr();
-    if (ptr->empty())
-        ptr->emplace_back (message, nullptr);
-    else
-    {
-        DiagnosticContext const & dc = ptr->back();
-        ptr->emplace_back (message, &dc);
-    }
+    SharedDiagnosticContextFrame & top = *getPtr();
+    top = std::make_shared<DiagnosticContextFrame const> (
+        log4cplus::tstring (message), std::move (top));
 }
 
 
 void
 NDC::setMaxDepth(std::size_t maxDepth)
 {
-    DiagnosticContextStack* ptr = getPtr();
-    while(maxDepth < ptr->size())
-        ptr->pop_back();
+    SharedDiagnosticContextFrame & top = *getPtr();
+    while (top && maxDepth < top->getDepth())
+        top = SharedDiagnosticContextFrame (top->getParent());
 }
 
 
-DiagnosticContextStack* NDC::getPtr()
+SharedDiagnosticContextFrame* NDC::getPtr()
 {
     internal::per_thread_data * ptd = internal::get_ptd ();
     return &ptd->ndc_dcs;
@@ -336,6 +384,32 @@ CATCH_TEST_CASE ("NDC", "[NDC]")
         CATCH_REQUIRE (ndc.getDepth () == 1);
     }
 
+    CATCH_SECTION ("snapshot")
+    {
+        ndc.push (CONTEXT1);
+        ndc.push (CONTEXT2);
+        SharedDiagnosticContextFrame const snapshot = ndc.getSnapshot ();
+        ndc.pop_void ();
+        ndc.push (CONTEXT3);
+        CATCH_REQUIRE (snapshot->getFullMessage () == C1C2);
+        CATCH_REQUIRE (snapshot->getDepth () == 2);
+
+        ndc.clear ();
+        ndc.inherit (snapshot);
+        CATCH_REQUIRE (ndc.get () == C1C2);
+        ndc.push (CONTEXT3);
+        CATCH_REQUIRE (ndc.get () == C1C2C3);
+
+        DiagnosticContextStack const stack = ndc.cloneStack ();
+        CATCH_REQUIRE (stack.size () == 3);
+        CATCH_REQUIRE (stack.back ().fullMessage == C1C2C3);
+        ndc.clear ();
+        ndc.inherit (stack);
+        CATCH_REQUIRE (ndc.get () == C1C2C3);
+        CATCH_REQUIRE (ndc.peek () == CONTEXT3);
+        ndc.clear ();
+    }
+
     CATCH_SECTION ("remove")
     {
         ndc.push (CONTEXT1);
@@ -57,6 +57,13 @@ NullAppender::close()
 }
 
 
+unsigned
+NullAppender::getEventFields() const
+{
+    return getLayoutEventFields ();
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // NullAppender protected methods
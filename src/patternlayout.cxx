@@ -104,6 +104,13 @@ public:
     virtual void convert(tstring & result,
         const spi::InternalLoggingEvent& event) = 0;
 
+    //! Optional event fields read by this converter, see
+    //! spi::EventField.
+    virtual unsigned getEventFields() const
+    {
+        return spi::EVENT_FIELDS_NONE;
+    }
+
 private:
     int minLen;
     std::size_t maxLen;
@@ -157,6 +164,7 @@ public:
     BasicPatternConverter(const FormattingInfo& info, Type type);
     void convert(tstring & result,
         const spi::InternalLoggingEvent& event) override;
+    unsigned getEventFields() const override;
 
 private:
   // Disable copy
@@ -197,6 +205,10 @@ public:
                          bool use_gmtime);
     void convert(tstring & result,
         const spi::InternalLoggingEvent& event) override;
+    unsigned getEventFields() const override
+    {
+        return spi::EVENT_FIELD_TIMESTAMP;
+    }
 
 private:
     bool use_gmtime;
@@ -225,6 +237,10 @@ public:
     explicit RelativeTimestampConverter(const FormattingInfo& info);
     void convert(tstring & result,
         const spi::InternalLoggingEvent& event) override;
+    unsigned getEventFields() const override
+    {
+        return spi::EVENT_FIELD_TIMESTAMP;
+    }
 };
 
 
@@ -254,6 +270,10 @@ public:
     MDCPatternConverter(const FormattingInfo& info, tstring const & k);
     void convert(tstring & result,
         const spi::InternalLoggingEvent& event) override;
+    unsigned getEventFields() const override
+    {
+        return spi::EVENT_FIELD_MDC;
+    }
 
 private:
     tstring key;
@@ -270,6 +290,10 @@ public:
     NDCPatternConverter(const FormattingInfo& info, int precision);
     void convert(tstring & result,
         const spi::InternalLoggingEvent& event) override;
+    unsigned getEventFields() const override
+    {
+        return spi::EVENT_FIELD_NDC;
+    }
 
 private:
     int precision;
@@ -491,6 +515,33 @@ BasicPatternConverter::convert(tstring & result,
 }
 
 
+unsigned
+BasicPatternConverter::getEventFields() const
+{
+    switch(type)
+    {
+    case NDC_CONVERTER:
+        return spi::EVENT_FIELD_NDC;
+
+    case THREAD_CONVERTER:
+        return spi::EVENT_FIELD_THREAD;
+
+    case THREAD2_CONVERTER:
+        return spi::EVENT_FIELD_THREAD2;
+
+    case BASENAME_CONVERTER:
+    case FILE_CONVERTER:
+    case LINE_CONVERTER:
+    case FULL_LOCATION_CONVERTER:
+    case FUNCTION_CONVERTER:
+        return spi::EVENT_FIELD_LOCATION;
+
+    default:
+        return spi::EVENT_FIELDS_NONE;
+    }
+}
+
+
 
 ////////////////////////////////////////////////
 // LoggerPatternConverter methods:
@@ -1078,6 +1129,16 @@ PatternLayout::init(const tstring& pattern_, unsigned ndcMaxDepth)
     pattern = pattern_;
     parsedPattern = pattern::PatternParser(pattern, ndcMaxDepth).parse();
 
+    formatKey = LOG4CPLUS_TEXT ("PatternLayout ");
+    formatKey += helpers::convertIntegerToString (ndcMaxDepth);
+    formatKey += LOG4CPLUS_TEXT (' ');
+    formatKey += pattern;
+
+    eventFields = spi::EVENT_FIELDS_NONE;
+    for (auto const & pc : parsedPattern)
+        if (pc)
+            eventFields |= pc->getEventFields ();
+
     // Let's validate that our parser didn't give us any NULLs.  If it did,
     // we will convert them to a valid PatternConverter that does nothing so
     // at least we don't core.
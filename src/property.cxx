@@ -219,18 +219,26 @@ imbue_file_from_flags ([[maybe_unused]] tistream & file, unsigned flags)
  *
  * @param val The string on which variable substitution is performed.
  * @param dest The result.
+ * @param cache Optional memo of environment variable values.
  */
 bool
 substVars (tstring & dest, const tstring & val,
     helpers::Properties const & props, helpers::LogLog& loglog,
-    unsigned flags)
+    unsigned flags, SubstVarsCache * cache)
 {
     tchar constexpr DELIM_START[] = LOG4CPLUS_TEXT("${");
     tchar constexpr DELIM_STOP[] = LOG4CPLUS_TEXT("}");
     std::size_t constexpr DELIM_START_LEN = 2;
     std::size_t constexpr DELIM_STOP_LEN = 1;
 
-    tstring::size_type i = 0;
+    // Most values do not contain any variable.
+    tstring::size_type i = val.find(DELIM_START);
+    if (i == tstring::npos)
+    {
+        dest = val;
+        return false;
+    }
+
     tstring::size_type var_start, var_end;
     tstring pattern (val);
     tstring key;
@@ -272,7 +280,17 @@ substVars (tstring & dest, const tstring & val,
         if (shadow_env)
             replacement = props.getProperty (key);
         if (! shadow_env || (! empty_vars && replacement.empty ()))
-            internal::get_env_var (replacement, key);
+        {
+            if (! cache)
+                internal::get_env_var (replacement, key);
+            else if (auto it = cache->find (key); it != cache->end ())
+                replacement = it->second;
+            else
+            {
+                internal::get_env_var (replacement, key);
+                cache->emplace (key, replacement);
+            }
+        }
 
         if (empty_vars || ! replacement.empty ())
         {
@@ -473,13 +491,14 @@ Properties::getPropertySubset(const log4cplus::tstring& prefix) const
 {
     Properties ret;
     auto const prefix_len = prefix.size ();
-    std::vector<tstring> keys = propertyNames();
-    for (tstring const & key : keys)
-    {
-        int result = key.compare (0, prefix_len, prefix);
-        if (result == 0)
-            ret.setProperty (key.substr (prefix_len), getProperty(key));
-    }
+
+    // Keys starting with the prefix form a contiguous range of the ordered
+    // map and they stay ordered after the prefix is trimmed.
+    for (auto it = data.lower_bound (prefix);
+         it != data.end () && it->first.compare (0, prefix_len, prefix) == 0;
+         ++it)
+        ret.data.emplace_hint (ret.data.end (), it->first.substr (prefix_len),
+            it->second);
 
     return ret;
 }
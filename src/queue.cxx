@@ -25,18 +25,37 @@
 #ifndef LOG4CPLUS_SINGLE_THREADED
 
 #include <log4cplus/helpers/queue.h>
+#include <log4cplus/appender.h>
 #include <log4cplus/helpers/loglog.h>
 #include <log4cplus/thread/syncprims-pub-impl.h>
 #include <stdexcept>
 #include <algorithm>
 #include <iterator>
 
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <vector>
+#include <catch_amalgamated.hpp>
+#endif
+
 
 namespace log4cplus::thread {
 
 
+namespace
+{
+
+//! Maximal number of normal events handed to the consumer at once when
+//! the priority lane is enabled.
+std::size_t const PRIORITY_LANE_BATCH = 64;
+
+} // namespace
+
+
 Queue::Queue (unsigned len)
-    : ev_consumer (false)
+    : priority_lane (false)
+    , priority_level (NOT_SET_LOG_LEVEL)
+    , merge_lanes (false)
+    , ev_consumer (false)
     , sem (len, len)
     , flags (DRAIN)
 { }
@@ -65,7 +84,7 @@ Queue::put_event (spi::InternalLoggingEvent const & ev)
         }
         else
         {
-            queue.push_back (ev);
+            lane_of (ev).push_back (ev);
             ret_flags |= ERROR_AFTER;
             semguard.detach ();
             flags |= QUEUE;
@@ -88,6 +107,131 @@ Queue::put_event (spi::InternalLoggingEvent const & ev)
 }
 
 
+Queue::flags_type
+Queue::put_event (spi::InternalLoggingEvent const & ev,
+    AsyncOverflow const & overflow)
+{
+    if (overflow.policy == AsyncOverflowPolicy::block)
+        return put_event (ev);
+
+    try
+    {
+        ev.gatherThreadSpecificData ();
+
+        if (! sem.timed_lock (0))
+        {
+            switch (overflow.policy)
+            {
+            case AsyncOverflowPolicy::block:
+                break;
+
+            case AsyncOverflowPolicy::block_timeout:
+                if (! sem.timed_lock (static_cast<unsigned long>(
+                        overflow.timeout.count ())))
+                    return DROPPED;
+                break;
+
+            case AsyncOverflowPolicy::drop_newest:
+                return DROPPED;
+
+            case AsyncOverflowPolicy::synchronous:
+                return FULL;
+
+            case AsyncOverflowPolicy::drop_oldest:
+            case AsyncOverflowPolicy::drop_below_level:
+            {
+                bool const by_level
+                    = overflow.policy == AsyncOverflowPolicy::drop_below_level;
+                if (by_level && ev.getLogLevel () < overflow.level)
+                    return DROPPED;
+
+                MutexGuard mguard (mutex);
+                if (flags & EXIT)
+                    return flags;
+
+                // Replace a queued event; the number of queued events and
+                // of semaphore's free slots stays the same.
+                auto const droppable
+                    = [&] (spi::InternalLoggingEvent const & queued) {
+                        return ! by_level
+                            || queued.getLogLevel () < overflow.level; };
+                queue_storage_type * lane = &queue;
+                auto it = std::find_if (queue.begin (), queue.end (),
+                    droppable);
+                if (it == queue.end ())
+                {
+                    lane = &priority_queue;
+                    it = std::find_if (priority_queue.begin (),
+                        priority_queue.end (), droppable);
+                }
+                if (it != lane->end ())
+                {
+                    lane->erase (it);
+                    lane_of (ev).push_back (ev);
+                    flags |= QUEUE;
+                    flags_type const ret_flags = flags | DROPPED;
+                    mguard.unlock ();
+                    mguard.detach ();
+                    ev_consumer.signal ();
+                    return ret_flags;
+                }
+
+                // Nothing to replace, the consumer has just taken the
+                // queued events or they are all severe. Wait for a slot.
+                mguard.unlock ();
+                mguard.detach ();
+                sem.lock ();
+                break;
+            }
+            }
+        }
+    }
+    catch (std::runtime_error const & e)
+    {
+        log4cplus::helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("put_event() exception: ")
+            + LOG4CPLUS_C_STR_TO_TSTRING(e.what()));
+        return ERROR_BIT;
+    }
+
+    // A slot has been acquired, queue the event.
+    flags_type ret_flags = ERROR_BIT;
+    try
+    {
+        SemaphoreGuard semguard;
+        semguard.attach (sem);
+        MutexGuard mguard (mutex);
+
+        ret_flags |= flags;
+
+        if (flags & EXIT)
+        {
+            ret_flags &= ~(ERROR_BIT | ERROR_AFTER);
+            return ret_flags;
+        }
+
+        lane_of (ev).push_back (ev);
+        ret_flags |= ERROR_AFTER;
+        semguard.detach ();
+        flags |= QUEUE;
+        ret_flags |= flags;
+        mguard.unlock ();
+        mguard.detach ();
+        ev_consumer.signal ();
+    }
+    catch (std::runtime_error const & e)
+    {
+        log4cplus::helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("put_event() exception: ")
+            + LOG4CPLUS_C_STR_TO_TSTRING(e.what()));
+        return ret_flags;
+    }
+
+    ret_flags &= ~(ERROR_BIT | ERROR_AFTER);
+    return ret_flags;
+}
+
+
 Queue::flags_type
 Queue::signal_exit (bool drain)
 {
@@ -141,12 +285,20 @@ Queue::get_events (queue_storage_type * buf)
             if (((QUEUE & flags) && ! (EXIT & flags))
                 || ((EXIT | DRAIN | QUEUE) & flags) == (EXIT | DRAIN | QUEUE))
             {
-                assert (! queue.empty ());
-
-                std::size_t const count = queue.size ();
-                queue.swap (*buf);
-                queue.clear ();
-                flags &= ~QUEUE;
+                assert (! queue.empty () || ! priority_queue.empty ());
+
+                std::size_t count;
+                if (! priority_lane && priority_queue.empty ())
+                {
+                    count = queue.size ();
+                    queue.swap (*buf);
+                    queue.clear ();
+                }
+                else
+                    count = take_batch (buf);
+
+                if (queue.empty () && priority_queue.empty ())
+                    flags &= ~QUEUE;
                 for (std::size_t i = 0; i != count; ++i)
                     sem.unlock ();
 
@@ -155,8 +307,9 @@ Queue::get_events (queue_storage_type * buf)
             }
             else if (((EXIT | QUEUE) & flags) == (EXIT | QUEUE))
             {
-                assert (! queue.empty ());
+                assert (! queue.empty () || ! priority_queue.empty ());
                 queue.clear ();
+                priority_queue.clear ();
                 flags &= ~QUEUE;
                 ev_consumer.reset ();
                 sem.unlock ();
@@ -186,6 +339,180 @@ Queue::get_events (queue_storage_type * buf)
 }
 
 
+void
+Queue::set_priority_lane (LogLevel level, bool merge)
+{
+    MutexGuard mguard (mutex);
+    priority_lane = true;
+    priority_level = level;
+    merge_lanes = merge;
+}
+
+
+Queue::queue_storage_type &
+Queue::lane_of (spi::InternalLoggingEvent const & ev)
+{
+    return priority_lane && ev.getLogLevel () >= priority_level
+        ? priority_queue : queue;
+}
+
+
+std::size_t
+Queue::take_batch (queue_storage_type * buf)
+{
+    std::size_t const normal_count
+        = (std::min) (queue.size (), PRIORITY_LANE_BATCH);
+    auto const normal_end = queue.begin () + normal_count;
+
+    buf->clear ();
+    if (merge_lanes)
+        std::merge (std::make_move_iterator (priority_queue.begin ()),
+            std::make_move_iterator (priority_queue.end ()),
+            std::make_move_iterator (queue.begin ()),
+            std::make_move_iterator (normal_end),
+            std::back_inserter (*buf),
+            [] (spi::InternalLoggingEvent const & a,
+                spi::InternalLoggingEvent const & b) {
+                return a.getTimestamp () < b.getTimestamp (); });
+    else
+    {
+        std::move (priority_queue.begin (), priority_queue.end (),
+            std::back_inserter (*buf));
+        std::move (queue.begin (), normal_end, std::back_inserter (*buf));
+    }
+
+    priority_queue.clear ();
+    queue.erase (queue.begin (), normal_end);
+    return buf->size ();
+}
+
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+CATCH_TEST_CASE ("Queue overflow policies", "[queue]")
+{
+    auto const event = [] (LogLevel ll, tstring_view message) {
+        return spi::InternalLoggingEvent (LOG4CPLUS_TEXT ("queue"), ll,
+            message, __FILE__, __LINE__);
+    };
+
+    auto const messages = [] (Queue & q) {
+        Queue::queue_storage_type buf;
+        q.get_events (&buf);
+        std::vector<tstring> ret;
+        for (auto const & ev : buf)
+            ret.push_back (ev.getMessage ());
+        return ret;
+    };
+
+    using strings = std::vector<tstring>;
+
+    QueuePtr q (new Queue (2));
+    q->put_event (event (INFO_LOG_LEVEL, LOG4CPLUS_TEXT ("1")));
+    q->put_event (event (ERROR_LOG_LEVEL, LOG4CPLUS_TEXT ("2")));
+
+    AsyncOverflow overflow;
+    auto const info3 = event (INFO_LOG_LEVEL, LOG4CPLUS_TEXT ("3"));
+    auto const error3 = event (ERROR_LOG_LEVEL, LOG4CPLUS_TEXT ("3"));
+
+    CATCH_SECTION ("drop newest")
+    {
+        overflow.policy = AsyncOverflowPolicy::drop_newest;
+        CATCH_REQUIRE ((q->put_event (info3, overflow) & Queue::DROPPED));
+        CATCH_REQUIRE (messages (*q) == strings {
+            LOG4CPLUS_TEXT ("1"), LOG4CPLUS_TEXT ("2")});
+
+        // There is room again.
+        CATCH_REQUIRE (! (q->put_event (info3, overflow) & Queue::DROPPED));
+        CATCH_REQUIRE (messages (*q) == strings {LOG4CPLUS_TEXT ("3")});
+    }
+
+    CATCH_SECTION ("block with timeout")
+    {
+        overflow.policy = AsyncOverflowPolicy::block_timeout;
+        overflow.timeout = std::chrono::milliseconds (10);
+        CATCH_REQUIRE ((q->put_event (info3, overflow) & Queue::DROPPED));
+        CATCH_REQUIRE (messages (*q) == strings {
+            LOG4CPLUS_TEXT ("1"), LOG4CPLUS_TEXT ("2")});
+    }
+
+    CATCH_SECTION ("drop oldest")
+    {
+        overflow.policy = AsyncOverflowPolicy::drop_oldest;
+        CATCH_REQUIRE ((q->put_event (info3, overflow) & Queue::DROPPED));
+        CATCH_REQUIRE (messages (*q) == strings {
+            LOG4CPLUS_TEXT ("2"), LOG4CPLUS_TEXT ("3")});
+    }
+
+    CATCH_SECTION ("drop below level")
+    {
+        overflow.policy = AsyncOverflowPolicy::drop_below_level;
+        CATCH_REQUIRE ((q->put_event (info3, overflow) & Queue::DROPPED));
+        CATCH_REQUIRE ((q->put_event (error3, overflow) & Queue::DROPPED));
+        CATCH_REQUIRE (messages (*q) == strings {
+            LOG4CPLUS_TEXT ("2"), LOG4CPLUS_TEXT ("3")});
+    }
+
+    CATCH_SECTION ("synchronous")
+    {
+        overflow.policy = AsyncOverflowPolicy::synchronous;
+        Queue::flags_type const ret = q->put_event (info3, overflow);
+        CATCH_REQUIRE ((ret & Queue::FULL));
+        CATCH_REQUIRE (! (ret & Queue::DROPPED));
+        CATCH_REQUIRE (messages (*q) == strings {
+            LOG4CPLUS_TEXT ("1"), LOG4CPLUS_TEXT ("2")});
+    }
+}
+
+
+CATCH_TEST_CASE ("Queue priority lane", "[queue]")
+{
+    QueuePtr q (new Queue (1000));
+    for (int i = 0; i != 100; ++i)
+        q->put_event (spi::InternalLoggingEvent (LOG4CPLUS_TEXT ("queue"),
+            INFO_LOG_LEVEL, LOG4CPLUS_TEXT ("info"), __FILE__, __LINE__));
+    spi::InternalLoggingEvent const error (LOG4CPLUS_TEXT ("queue"),
+        ERROR_LOG_LEVEL, LOG4CPLUS_TEXT ("error"), __FILE__, __LINE__);
+
+    Queue::queue_storage_type buf;
+
+    CATCH_SECTION ("priority events come first")
+    {
+        q->set_priority_lane (ERROR_LOG_LEVEL);
+        q->put_event (error);
+
+        CATCH_REQUIRE ((q->get_events (&buf) & Queue::EVENT));
+        CATCH_REQUIRE (buf.size () == 1 + PRIORITY_LANE_BATCH);
+        CATCH_REQUIRE (buf.front ().getLogLevel () == ERROR_LOG_LEVEL);
+
+        // The rest of the backlog follows in the next batch.
+        CATCH_REQUIRE ((q->get_events (&buf) & Queue::EVENT));
+        CATCH_REQUIRE (buf.size () == 100 - PRIORITY_LANE_BATCH);
+    }
+
+    CATCH_SECTION ("merged lanes keep timestamp order")
+    {
+        q->set_priority_lane (ERROR_LOG_LEVEL, true);
+        q->put_event (error);
+
+        CATCH_REQUIRE ((q->get_events (&buf) & Queue::EVENT));
+        CATCH_REQUIRE (buf.size () == 1 + PRIORITY_LANE_BATCH);
+        CATCH_REQUIRE (std::is_sorted (buf.begin (), buf.end (),
+            [] (spi::InternalLoggingEvent const & a,
+                spi::InternalLoggingEvent const & b) {
+                return a.getTimestamp () < b.getTimestamp (); }));
+    }
+
+    CATCH_SECTION ("without priority lane the whole queue is taken")
+    {
+        q->put_event (error);
+        CATCH_REQUIRE ((q->get_events (&buf) & Queue::EVENT));
+        CATCH_REQUIRE (buf.size () == 101);
+        CATCH_REQUIRE (buf.back ().getLogLevel () == ERROR_LOG_LEVEL);
+    }
+}
+#endif
+
+
 } // namespace log4cplus::thread
 
 
@@ -45,7 +45,7 @@ RootLogger::RootLogger(Hierarchy& h, LogLevel loglevel)
 LogLevel 
 RootLogger::getChainedLogLevel() const
 {
-    return ll;
+    return ll.load (std::memory_order_relaxed);
 }
 
 
@@ -0,0 +1,670 @@
+// -*- C++ -*-
+//  Copyright (C) 2026, log4cplus contributors. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <log4cplus/helpers/sharedmemoryring.h>
+#include <log4cplus/helpers/loglog.h>
+#include <log4cplus/helpers/stringhelper.h>
+#include <log4cplus/internal/socket.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined (LOG4CPLUS_HAVE_MEMFD_CREATE) \
+    && defined (LOG4CPLUS_HAVE_SYS_EVENTFD_H)
+#define LOG4CPLUS_HAVE_SHARED_MEMORY_RING
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS) \
+    && defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING) \
+    && ! defined (LOG4CPLUS_SINGLE_THREADED)
+#include <thread>
+#include <catch_amalgamated.hpp>
+#endif
+
+
+namespace log4cplus::helpers {
+
+
+#if defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING)
+namespace
+{
+
+std::uint32_t const RING_MAGIC = 0x4c344352u;
+std::uint32_t const RING_VERSION = 1;
+
+//! Length of a record that marks the rest of the ring up to its end as
+//! unused. The next record starts at the beginning of the ring.
+std::uint32_t const WRAP_MARKER = 0xffffffffu;
+
+std::size_t const MIN_CAPACITY = std::size_t (64) * 1024;
+std::size_t const MAX_CAPACITY = std::size_t (1) << 30;
+
+//! Records start at multiples of this, so that there is always space
+//! for WRAP_MARKER before the end of the ring.
+std::size_t const RECORD_ALIGN = 8;
+
+//! Number of descriptors handed over by offer().
+std::size_t const RING_FDS = 3;
+
+
+//! Placed at the beginning of the shared memory, records follow it.
+//! Positions grow monotonically, offsets into the ring are positions
+//! modulo its capacity.
+struct RingHeader
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t capacity;
+
+    //! End of published records. Written by the producer only.
+    alignas (64) std::atomic<std::uint64_t> head;
+    //! Set by the consumer before it sleeps on the data doorbell.
+    std::atomic<std::uint32_t> consumer_waiting;
+
+    //! End of consumed records. Written by the consumer only.
+    alignas (64) std::atomic<std::uint64_t> tail;
+    //! Set by the producer before it sleeps on the space doorbell.
+    std::atomic<std::uint32_t> producer_waiting;
+};
+
+static_assert (std::atomic<std::uint64_t>::is_always_lock_free
+    && std::atomic<std::uint32_t>::is_always_lock_free,
+    "Atomics shared between processes have to be lock free.");
+
+
+std::size_t const DATA_OFFSET
+    = (sizeof (RingHeader) + 63) & ~static_cast<std::size_t> (63);
+
+
+std::uint64_t
+record_size (std::uint64_t payload)
+{
+    return (sizeof (std::uint32_t) + payload + RECORD_ALIGN - 1)
+        & ~static_cast<std::uint64_t> (RECORD_ALIGN - 1);
+}
+
+
+void
+close_fd (int & fd)
+{
+    if (fd != -1)
+    {
+        ::close (fd);
+        fd = -1;
+    }
+}
+
+
+void
+ring_doorbell (int doorbell)
+{
+    std::uint64_t const one = 1;
+    // The write fails only if the counter would overflow. The other side
+    // has plenty of wake ups pending then.
+    [[maybe_unused]] ssize_t const ret
+        = ::write (doorbell, &one, sizeof (one));
+}
+
+
+void
+report_error (tchar const * msg)
+{
+    int const eno = errno;
+    getLogLog ().error (tstring (msg) + LOG4CPLUS_TEXT (", errno: ")
+        + convertIntegerToString (eno));
+}
+
+} // namespace
+
+
+struct SharedMemoryRing::Impl
+{
+    ~Impl ()
+    {
+        if (header)
+            ::munmap (header, DATA_OFFSET + capacity);
+
+        for (int * fd : {&memfd, &data_doorbell, &space_doorbell})
+            close_fd (*fd);
+    }
+
+    bool map (int prot);
+    bool wait (int doorbell);
+    void release (std::uint64_t size);
+
+    //! Connected socket of the peer. Not owned.
+    int peer = -1;
+    int memfd = -1;
+    //! Rung by the producer when the consumer waits for records.
+    int data_doorbell = -1;
+    //! Rung by the consumer when the producer waits for space.
+    int space_doorbell = -1;
+    RingHeader * header = nullptr;
+    char * data = nullptr;
+    std::uint64_t capacity = 0;
+    //! Producer's head or consumer's tail.
+    std::uint64_t position = 0;
+    //! Size of the record last handed out by read().
+    std::uint64_t pending = 0;
+};
+
+
+bool
+SharedMemoryRing::Impl::map (int prot)
+{
+    void * const mem = ::mmap (nullptr, DATA_OFFSET + capacity, prot,
+        MAP_SHARED, memfd, 0);
+    if (mem == MAP_FAILED)
+        return false;
+
+    header = static_cast<RingHeader *> (mem);
+    data = static_cast<char *> (mem) + DATA_OFFSET;
+    return true;
+}
+
+
+//! Waits until `doorbell` is rung. Returns false if the peer has gone
+//! away instead.
+bool
+SharedMemoryRing::Impl::wait (int doorbell)
+{
+    struct pollfd fds[2] = {{doorbell, POLLIN, 0}, {peer, POLLIN, 0}};
+    int ret;
+    while ((ret = ::poll (fds, 2, -1)) == -1 && errno == EINTR)
+        ;
+    if (ret == -1)
+        return false;
+
+    if (fds[0].revents & POLLIN)
+    {
+        std::uint64_t count;
+        [[maybe_unused]] ssize_t const r
+            = ::read (doorbell, &count, sizeof (count));
+        return true;
+    }
+
+    // Nothing is sent over the socket once the ring has been handed
+    // over. It becomes readable only when the peer closes it.
+    return false;
+}
+
+
+//! Consumer side. Returns `size` bytes of the ring to the producer.
+void
+SharedMemoryRing::Impl::release (std::uint64_t size)
+{
+    position += size;
+    header->tail.store (position, std::memory_order_seq_cst);
+    if (header->producer_waiting.load (std::memory_order_seq_cst))
+        ring_doorbell (space_doorbell);
+}
+
+#else
+struct SharedMemoryRing::Impl
+{ };
+
+#endif // defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING)
+
+
+//////////////////////////////////////////////////////////////////////////////
+// SharedMemoryRing ctors and dtor
+//////////////////////////////////////////////////////////////////////////////
+
+SharedMemoryRing::SharedMemoryRing () = default;
+
+
+SharedMemoryRing::SharedMemoryRing (std::unique_ptr<Impl> impl_)
+    : impl (std::move (impl_))
+{ }
+
+
+SharedMemoryRing::SharedMemoryRing (SharedMemoryRing &&) LOG4CPLUS_NOEXCEPT
+    = default;
+
+
+SharedMemoryRing::~SharedMemoryRing () = default;
+
+
+SharedMemoryRing &
+SharedMemoryRing::operator = (SharedMemoryRing &&) LOG4CPLUS_NOEXCEPT
+    = default;
+
+
+//////////////////////////////////////////////////////////////////////////////
+// SharedMemoryRing methods
+//////////////////////////////////////////////////////////////////////////////
+
+SharedMemoryRing
+SharedMemoryRing::offer (Socket & peer, std::size_t capacity)
+{
+#if defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING)
+    auto r = std::make_unique<Impl> ();
+    r->peer = to_os_socket (peer.getSocketHandle ());
+    r->capacity = MIN_CAPACITY;
+    while (r->capacity < capacity && r->capacity < MAX_CAPACITY)
+        r->capacity *= 2;
+
+    // The seals keep the consumer safe from SIGBUS due to the memory
+    // being shrunk under it.
+    r->memfd = ::memfd_create ("log4cplus-ring",
+        MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (r->memfd == -1
+        || ::ftruncate (r->memfd,
+            static_cast<off_t> (DATA_OFFSET + r->capacity)) == -1
+        || ::fcntl (r->memfd, F_ADD_SEALS,
+            F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == -1
+        || ! r->map (PROT_READ | PROT_WRITE))
+    {
+        report_error (LOG4CPLUS_TEXT ("SharedMemoryRing::offer()")
+            LOG4CPLUS_TEXT ("- cannot create shared memory"));
+        return SharedMemoryRing ();
+    }
+
+    new (r->header) RingHeader {RING_MAGIC, RING_VERSION, r->capacity,
+        {0}, {0}, {0}, {0}};
+
+    r->data_doorbell = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+    r->space_doorbell = ::eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (r->data_doorbell == -1 || r->space_doorbell == -1)
+    {
+        report_error (LOG4CPLUS_TEXT ("SharedMemoryRing::offer()")
+            LOG4CPLUS_TEXT ("- cannot create eventfd"));
+        return SharedMemoryRing ();
+    }
+
+    int const fds[RING_FDS] {r->memfd, r->data_doorbell, r->space_doorbell};
+    alignas (struct cmsghdr) char control[CMSG_SPACE (sizeof (fds))] {};
+    std::uint32_t version = RING_VERSION;
+    struct iovec iov {&version, sizeof (version)};
+    struct msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof (control);
+    struct cmsghdr * const cmsg = CMSG_FIRSTHDR (&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN (sizeof (fds));
+    std::memcpy (CMSG_DATA (cmsg), fds, sizeof (fds));
+
+    ssize_t ret;
+    while ((ret = ::sendmsg (r->peer, &msg, MSG_NOSIGNAL)) == -1
+        && errno == EINTR)
+        ;
+    if (ret != static_cast<ssize_t> (sizeof (version)))
+    {
+        report_error (LOG4CPLUS_TEXT ("SharedMemoryRing::offer()")
+            LOG4CPLUS_TEXT ("- cannot hand over shared memory"));
+        return SharedMemoryRing ();
+    }
+
+    return SharedMemoryRing (std::move (r));
+
+#else
+    (void) peer;
+    (void) capacity;
+    getLogLog ().error (LOG4CPLUS_TEXT ("SharedMemoryRing::offer()")
+        LOG4CPLUS_TEXT ("- shared memory ring is not supported"));
+    return SharedMemoryRing ();
+#endif
+}
+
+
+SharedMemoryRing
+SharedMemoryRing::accept (Socket & peer)
+{
+#if defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING)
+    auto r = std::make_unique<Impl> ();
+    r->peer = to_os_socket (peer.getSocketHandle ());
+
+    alignas (struct cmsghdr) char control[
+        CMSG_SPACE (sizeof (int) * RING_FDS)] {};
+    std::uint32_t version = 0;
+    struct iovec iov {&version, sizeof (version)};
+    struct msghdr msg {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof (control);
+
+    ssize_t ret;
+    while ((ret = ::recvmsg (r->peer, &msg, MSG_CMSG_CLOEXEC)) == -1
+        && errno == EINTR)
+        ;
+
+    // Take ownership of whatever descriptors have arrived first, so
+    // that they are closed on any failure.
+    std::size_t count = 0;
+    int fds[RING_FDS] {-1, -1, -1};
+    if (ret != -1)
+        for (struct cmsghdr * cmsg = CMSG_FIRSTHDR (&msg); cmsg;
+             cmsg = CMSG_NXTHDR (&msg, cmsg))
+        {
+            if (cmsg->cmsg_level != SOL_SOCKET
+                || cmsg->cmsg_type != SCM_RIGHTS)
+                continue;
+
+            std::size_t const n = (cmsg->cmsg_len - CMSG_LEN (0))
+                / sizeof (int);
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                int fd;
+                std::memcpy (&fd, CMSG_DATA (cmsg) + i * sizeof (int),
+                    sizeof (fd));
+                if (count != RING_FDS)
+                    fds[count++] = fd;
+                else
+                    ::close (fd);
+            }
+        }
+    r->memfd = fds[0];
+    r->data_doorbell = fds[1];
+    r->space_doorbell = fds[2];
+
+    if (ret != static_cast<ssize_t> (sizeof (version))
+        || version != RING_VERSION || count != RING_FDS
+        || (msg.msg_flags & MSG_CTRUNC))
+    {
+        report_error (LOG4CPLUS_TEXT ("SharedMemoryRing::accept()")
+            LOG4CPLUS_TEXT ("- no shared memory has been handed over"));
+        return SharedMemoryRing ();
+    }
+
+    // The ring is sized by the memory, not by what its header claims.
+    struct stat st;
+    int const seals = ::fcntl (r->memfd, F_GET_SEALS);
+    if (seals == -1 || ! (seals & F_SEAL_SHRINK)
+        || ::fstat (r->memfd, &st) == -1
+        || st.st_size <= static_cast<off_t> (DATA_OFFSET))
+    {
+        report_error (LOG4CPLUS_TEXT ("SharedMemoryRing::accept()")
+            LOG4CPLUS_TEXT ("- shared memory is not sealed"));
+        return SharedMemoryRing ();
+    }
+
+    r->capacity = static_cast<std::uint64_t> (st.st_size) - DATA_OFFSET;
+    if (r->capacity < MIN_CAPACITY || r->capacity > MAX_CAPACITY
+        || (r->capacity & (r->capacity - 1)) != 0
+        || ! r->map (PROT_READ | PROT_WRITE)
+        || r->header->magic != RING_MAGIC
+        || r->header->capacity != r->capacity)
+    {
+        report_error (LOG4CPLUS_TEXT ("SharedMemoryRing::accept()")
+            LOG4CPLUS_TEXT ("- invalid shared memory ring"));
+        return SharedMemoryRing ();
+    }
+
+    r->position = r->header->tail.load (std::memory_order_acquire);
+    return SharedMemoryRing (std::move (r));
+
+#else
+    (void) peer;
+    getLogLog ().error (LOG4CPLUS_TEXT ("SharedMemoryRing::accept()")
+        LOG4CPLUS_TEXT ("- shared memory ring is not supported"));
+    return SharedMemoryRing ();
+#endif
+}
+
+
+bool
+SharedMemoryRing::isOpen () const
+{
+    return !! impl;
+}
+
+
+void
+SharedMemoryRing::close ()
+{
+    impl.reset ();
+}
+
+
+bool
+SharedMemoryRing::write (std::size_t bufferCount,
+    SocketBuffer const * const * buffers)
+{
+#if defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING)
+    if (! impl)
+        return false;
+
+    Impl & r = *impl;
+    RingHeader & header = *r.header;
+
+    std::uint64_t payload = 0;
+    for (std::size_t i = 0; i != bufferCount; ++i)
+        payload += buffers[i]->getSize ();
+
+    // A record might have to skip to the beginning of the ring, so it
+    // can take at most half of it.
+    std::uint64_t const size = record_size (payload);
+    if (size > r.capacity / 2)
+    {
+        getLogLog ().error (LOG4CPLUS_TEXT ("SharedMemoryRing::write()")
+            LOG4CPLUS_TEXT ("- record does not fit into the ring"));
+        return false;
+    }
+
+    std::uint64_t const offset = r.position & (r.capacity - 1);
+    std::uint64_t const skip = r.capacity - offset < size
+        ? r.capacity - offset : 0;
+    auto const has_space = [&] (std::memory_order order) {
+        std::uint64_t const used = r.position - header.tail.load (order);
+        return used <= r.capacity && r.capacity - used >= skip + size;
+    };
+
+    while (! has_space (std::memory_order_acquire))
+    {
+        if (r.position - header.tail.load (std::memory_order_acquire)
+            > r.capacity)
+        {
+            getLogLog ().error (LOG4CPLUS_TEXT ("SharedMemoryRing::write()")
+                LOG4CPLUS_TEXT ("- ring is corrupted"));
+            return false;
+        }
+
+        // Sequentially consistent accesses to the flag and to the
+        // positions make sure that either this side sees the consumer's
+        // progress or the consumer sees the flag and rings.
+        header.producer_waiting.store (1, std::memory_order_seq_cst);
+        bool const alive = has_space (std::memory_order_seq_cst)
+            || r.wait (r.space_doorbell);
+        header.producer_waiting.store (0, std::memory_order_relaxed);
+        if (! alive)
+            return false;
+    }
+
+    char * dest = r.data + offset;
+    if (skip != 0)
+    {
+        std::memcpy (dest, &WRAP_MARKER, sizeof (WRAP_MARKER));
+        dest = r.data;
+    }
+
+    auto const length = static_cast<std::uint32_t> (payload);
+    std::memcpy (dest, &length, sizeof (length));
+    dest += sizeof (length);
+    for (std::size_t i = 0; i != bufferCount; ++i)
+    {
+        std::memcpy (dest, buffers[i]->getBuffer (), buffers[i]->getSize ());
+        dest += buffers[i]->getSize ();
+    }
+
+    r.position += skip + size;
+    header.head.store (r.position, std::memory_order_seq_cst);
+    if (header.consumer_waiting.load (std::memory_order_seq_cst))
+        ring_doorbell (r.data_doorbell);
+
+    return true;
+
+#else
+    (void) bufferCount;
+    (void) buffers;
+    return false;
+#endif
+}
+
+
+bool
+SharedMemoryRing::read (char * & data, std::size_t & size)
+{
+#if defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING)
+    if (! impl)
+        return false;
+
+    Impl & r = *impl;
+    RingHeader & header = *r.header;
+
+    if (r.pending != 0)
+    {
+        r.release (r.pending);
+        r.pending = 0;
+    }
+
+    while (true)
+    {
+        std::uint64_t head = header.head.load (std::memory_order_acquire);
+        if (head == r.position)
+        {
+            header.consumer_waiting.store (1, std::memory_order_seq_cst);
+            head = header.head.load (std::memory_order_seq_cst);
+            bool const alive = head != r.position
+                || r.wait (r.data_doorbell);
+            header.consumer_waiting.store (0, std::memory_order_relaxed);
+
+            // Drain whatever the producer has published before leaving.
+            if (! alive
+                && header.head.load (std::memory_order_acquire) == r.position)
+                return false;
+
+            continue;
+        }
+
+        // The memory is shared with another process, do not trust it.
+        std::uint64_t const available = head - r.position;
+        std::uint64_t const offset = r.position & (r.capacity - 1);
+        std::uint32_t length;
+        std::memcpy (&length, r.data + offset, sizeof (length));
+        std::uint64_t const record = length == WRAP_MARKER
+            ? r.capacity - offset : record_size (length);
+        if (available > r.capacity || record > available
+            || record > r.capacity - offset)
+        {
+            getLogLog ().error (LOG4CPLUS_TEXT ("SharedMemoryRing::read()")
+                LOG4CPLUS_TEXT ("- ring is corrupted"));
+            return false;
+        }
+
+        if (length == WRAP_MARKER)
+        {
+            r.release (record);
+            continue;
+        }
+
+        data = r.data + offset + sizeof (length);
+        size = length;
+        r.pending = record;
+        return true;
+    }
+
+#else
+    (void) data;
+    (void) size;
+    return false;
+#endif
+}
+
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS) \
+    && defined (LOG4CPLUS_HAVE_SHARED_MEMORY_RING) \
+    && ! defined (LOG4CPLUS_SINGLE_THREADED)
+CATCH_TEST_CASE ("SharedMemoryRing", "[sockets]")
+{
+    int sv[2];
+    CATCH_REQUIRE (::socketpair (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv)
+        == 0);
+    Socket producer_sock (to_log4cplus_socket (sv[0]), SocketState::ok, 0);
+    Socket consumer_sock (to_log4cplus_socket (sv[1]), SocketState::ok, 0);
+
+    SharedMemoryRing producer = SharedMemoryRing::offer (producer_sock, 0);
+    CATCH_REQUIRE (producer.isOpen ());
+    SharedMemoryRing consumer = SharedMemoryRing::accept (consumer_sock);
+    CATCH_REQUIRE (consumer.isOpen ());
+
+    // Records of varying sizes wrap around the minimal ring many times
+    // and fill it up while the consumer is slower.
+    unsigned const count = 20000;
+    auto const payload_size = [] (unsigned i) {
+        return sizeof (unsigned) + (i * 37) % 3001; };
+
+    std::thread writer ([&] {
+        for (unsigned i = 0; i != count; ++i)
+        {
+            SocketBuffer head (sizeof (unsigned));
+            head.appendInt (i);
+            SocketBuffer tail (payload_size (i) - sizeof (unsigned));
+            std::memset (tail.getBuffer (), static_cast<char> (i),
+                tail.getMaxSize ());
+            tail.setSize (tail.getMaxSize ());
+            SocketBuffer const * const buffers[] {&head, &tail};
+            if (! producer.write (2, buffers))
+                break;
+        }
+        producer.close ();
+        producer_sock.close ();
+    });
+
+    unsigned received = 0;
+    bool intact = true;
+    char * data;
+    std::size_t size;
+    while (consumer.read (data, size))
+    {
+        SocketBuffer record (data, size);
+        unsigned const i = record.readInt ();
+        intact = intact && i == received && size == payload_size (i)
+            && (size == sizeof (unsigned)
+                || (data[sizeof (unsigned)] == static_cast<char> (i)
+                    && data[size - 1] == static_cast<char> (i)));
+        ++received;
+    }
+    writer.join ();
+
+    CATCH_REQUIRE (intact);
+    CATCH_REQUIRE (received == count);
+}
+#endif
+
+
+} // namespace log4cplus::helpers
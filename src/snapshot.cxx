@@ -0,0 +1,349 @@
+// -*- C++ -*-
+//  Copyright (C) 2026, log4cplus contributors. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without modifica-
+//  tion, are permitted provided that the following conditions are met:
+//
+//  1. Redistributions of  source code must  retain the above copyright  notice,
+//     this list of conditions and the following disclaimer.
+//
+//  2. Redistributions in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//  THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED WARRANTIES,
+//  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+//  FITNESS  FOR A PARTICULAR  PURPOSE ARE  DISCLAIMED.  IN NO  EVENT SHALL  THE
+//  APACHE SOFTWARE  FOUNDATION  OR ITS CONTRIBUTORS  BE LIABLE FOR  ANY DIRECT,
+//  INDIRECT, INCIDENTAL, SPECIAL,  EXEMPLARY, OR CONSEQUENTIAL  DAMAGES (INCLU-
+//  DING, BUT NOT LIMITED TO, PROCUREMENT  OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//  OF USE, DATA, OR  PROFITS; OR BUSINESS  INTERRUPTION)  HOWEVER CAUSED AND ON
+//  ANY  THEORY OF LIABILITY,  WHETHER  IN CONTRACT,  STRICT LIABILITY,  OR TORT
+//  (INCLUDING  NEGLIGENCE OR  OTHERWISE) ARISING IN  ANY WAY OUT OF THE  USE OF
+//  THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <log4cplus/helpers/snapshot.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <thread>
+#include <catch_amalgamated.hpp>
+#endif
+
+
+namespace log4cplus::helpers {
+
+
+namespace
+{
+
+//! Epoch of a thread that is not inside of any EpochGuard.
+std::uint64_t const QUIESCENT = 0;
+
+
+//! Per thread announcement of the epoch the thread has entered
+//! EpochGuard in. Records are never freed, they are reused by other
+//! threads after their owner exits.
+struct ThreadRecord
+{
+    std::atomic<std::uint64_t> epoch {QUIESCENT};
+    std::atomic<bool> in_use {true};
+    ThreadRecord * next = nullptr;
+};
+
+
+struct RetiredSnapshot
+{
+    void const * ptr;
+    void (* deleter) (void const *);
+    //! Global epoch at the time of retirement. Only readers that have
+    //! entered at this epoch or earlier can still see the snapshot.
+    std::uint64_t epoch;
+};
+
+
+//! Maximal number of snapshots destroyed by one EpochGuard on its exit.
+//! Expired snapshots over the limit are left for the next reclamation.
+std::size_t const GUARD_RECLAIM_LIMIT = 16;
+
+
+struct EpochDomain
+{
+    std::atomic<std::uint64_t> global_epoch {QUIESCENT + 1};
+    std::atomic<ThreadRecord *> records {nullptr};
+    std::atomic<std::size_t> retired_count {0};
+    //! Epoch of the most recently retired snapshot. A reader that has
+    //! entered at a later epoch does not hold back any retired snapshot.
+    std::atomic<std::uint64_t> newest_retired {QUIESCENT};
+    //! Set when the last reclamation left expired snapshots behind
+    //! because of its limit.
+    std::atomic<bool> expired_left {false};
+    std::mutex retired_mutex;
+    std::vector<RetiredSnapshot> retired;
+};
+
+
+//! The domain is intentionally leaked; snapshots and thread records can
+//! be touched from static destructors and thread exit handlers running
+//! after destruction of any static object.
+EpochDomain &
+get_domain ()
+{
+    static EpochDomain * const domain = new EpochDomain;
+    return *domain;
+}
+
+
+ThreadRecord *
+acquire_record (EpochDomain & domain)
+{
+    for (ThreadRecord * rec = domain.records.load (std::memory_order_acquire);
+         rec; rec = rec->next)
+    {
+        bool expected = false;
+        if (! rec->in_use.load (std::memory_order_relaxed)
+            && rec->in_use.compare_exchange_strong (expected, true,
+                std::memory_order_acquire))
+            return rec;
+    }
+
+    auto * const rec = new ThreadRecord;
+    rec->next = domain.records.load (std::memory_order_relaxed);
+    while (! domain.records.compare_exchange_weak (rec->next, rec,
+            std::memory_order_release, std::memory_order_relaxed))
+        ;
+
+    return rec;
+}
+
+
+struct thread_slot
+{
+    ThreadRecord * record = nullptr;
+    unsigned depth = 0;
+
+    ~thread_slot ()
+    {
+        if (record)
+            record->in_use.store (false, std::memory_order_release);
+    }
+};
+
+
+thread_local thread_slot epoch_slot;
+
+
+//! Destroys up to `limit` retired snapshots that no reader can see
+//! anymore. With `wait` false it gives up if another thread is already
+//! reclaiming.
+void
+reclaim (EpochDomain & domain, bool wait, std::size_t limit)
+{
+    std::unique_lock<std::mutex> guard (domain.retired_mutex,
+        std::defer_lock);
+    if (wait)
+        guard.lock ();
+    else if (! guard.try_lock ())
+        return;
+
+    std::uint64_t oldest = (std::numeric_limits<std::uint64_t>::max) ();
+    for (ThreadRecord * rec = domain.records.load (std::memory_order_acquire);
+         rec; rec = rec->next)
+    {
+        std::uint64_t const epoch = rec->epoch.load (std::memory_order_seq_cst);
+        if (epoch != QUIESCENT)
+            oldest = (std::min) (oldest, epoch);
+    }
+
+    auto const it = std::stable_partition (domain.retired.begin (),
+        domain.retired.end (),
+        [oldest] (RetiredSnapshot const & r) { return r.epoch >= oldest; });
+    auto const last = it + static_cast<std::ptrdiff_t> ((std::min) (limit,
+        static_cast<std::size_t> (domain.retired.end () - it)));
+    domain.expired_left.store (last != domain.retired.end (),
+        std::memory_order_relaxed);
+    std::vector<RetiredSnapshot> const expired (it, last);
+    domain.retired.erase (it, last);
+    domain.retired_count.store (domain.retired.size (),
+        std::memory_order_relaxed);
+    guard.unlock ();
+
+    // Deleters run unlocked, destroying a snapshot can retire others.
+    for (RetiredSnapshot const & r : expired)
+        r.deleter (r.ptr);
+}
+
+} // namespace
+
+
+//////////////////////////////////////////////////////////////////////////////
+// EpochGuard
+//////////////////////////////////////////////////////////////////////////////
+
+EpochGuard::EpochGuard ()
+{
+    thread_slot & slot = epoch_slot;
+    if (slot.depth++ != 0)
+        return;
+
+    EpochDomain & domain = get_domain ();
+    if (! slot.record)
+        slot.record = acquire_record (domain);
+
+    // Sequentially consistent store orders the announcement before loads
+    // of snapshot pointers that follow.
+    slot.record->epoch.store (
+        domain.global_epoch.load (std::memory_order_seq_cst),
+        std::memory_order_seq_cst);
+}
+
+
+EpochGuard::~EpochGuard ()
+{
+    thread_slot & slot = epoch_slot;
+    if (--slot.depth != 0)
+        return;
+
+    std::uint64_t const epoch
+        = slot.record->epoch.load (std::memory_order_relaxed);
+    slot.record->epoch.store (QUIESCENT, std::memory_order_release);
+
+    // Only a reader that has entered before the latest retirement can
+    // have been holding back any retired snapshot.
+    EpochDomain & domain = get_domain ();
+    if (domain.retired_count.load (std::memory_order_relaxed) != 0
+        && (epoch <= domain.newest_retired.load (std::memory_order_relaxed)
+            || domain.expired_left.load (std::memory_order_relaxed)))
+        reclaim (domain, false, GUARD_RECLAIM_LIMIT);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+// retireSnapshot()
+//////////////////////////////////////////////////////////////////////////////
+
+void
+retireSnapshot (void const * ptr, void (* deleter) (void const *))
+{
+    EpochDomain & domain = get_domain ();
+    std::uint64_t const epoch
+        = domain.global_epoch.fetch_add (1, std::memory_order_seq_cst);
+
+    {
+        std::lock_guard<std::mutex> guard (domain.retired_mutex);
+        domain.retired.push_back (RetiredSnapshot {ptr, deleter, epoch});
+        domain.retired_count.store (domain.retired.size (),
+            std::memory_order_relaxed);
+        if (epoch > domain.newest_retired.load (std::memory_order_relaxed))
+            domain.newest_retired.store (epoch, std::memory_order_relaxed);
+    }
+
+    reclaim (domain, true, (std::numeric_limits<std::size_t>::max) ());
+}
+
+
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+CATCH_TEST_CASE ("AtomicSnapshot", "[snapshot]")
+{
+    struct Counted
+    {
+        explicit Counted (int v, std::atomic<int> & d)
+            : value (v), destroyed (d)
+        { }
+
+        ~Counted ()
+        {
+            ++destroyed;
+        }
+
+        int value;
+        std::atomic<int> & destroyed;
+    };
+
+    std::atomic<int> destroyed {0};
+
+    CATCH_SECTION ("replaced snapshot without readers is destroyed at once")
+    {
+        AtomicSnapshot<Counted> snapshot;
+        snapshot.store (std::make_unique<Counted> (1, destroyed));
+        snapshot.store (std::make_unique<Counted> (2, destroyed));
+        CATCH_REQUIRE (destroyed == 1);
+
+        EpochGuard const guard;
+        CATCH_REQUIRE (snapshot.load ()->value == 2);
+    }
+
+    CATCH_SECTION ("replaced snapshot outlives nested readers")
+    {
+        AtomicSnapshot<Counted> snapshot;
+        snapshot.store (std::make_unique<Counted> (1, destroyed));
+        {
+            EpochGuard const outer;
+            Counted const * const seen = snapshot.load ();
+            {
+                EpochGuard const inner;
+                snapshot.store (std::make_unique<Counted> (2, destroyed));
+            }
+            CATCH_REQUIRE (destroyed == 0);
+            CATCH_REQUIRE (seen->value == 1);
+        }
+        CATCH_REQUIRE (destroyed == 1);
+    }
+
+    CATCH_SECTION ("reader in another thread delays destruction")
+    {
+        AtomicSnapshot<Counted> snapshot;
+        snapshot.store (std::make_unique<Counted> (1, destroyed));
+
+        std::atomic<int> step {0};
+        std::thread reader ([&] {
+            EpochGuard const guard;
+            Counted const * const seen = snapshot.load ();
+            step = 1;
+            while (step != 2)
+                std::this_thread::yield ();
+            // The snapshot has been replaced but it is still alive.
+            step = seen->value == 1 && destroyed == 0 ? 3 : 4;
+        });
+
+        while (step != 1)
+            std::this_thread::yield ();
+        snapshot.store (std::make_unique<Counted> (2, destroyed));
+        step = 2;
+        reader.join ();
+
+        CATCH_REQUIRE (step == 3);
+        CATCH_REQUIRE (destroyed == 1);
+    }
+
+    CATCH_SECTION ("guard exit destroys a bounded number of snapshots")
+    {
+        AtomicSnapshot<Counted> snapshot;
+        snapshot.store (std::make_unique<Counted> (0, destroyed));
+        {
+            EpochGuard const guard;
+            for (int i = 1; i != 41; ++i)
+                snapshot.store (std::make_unique<Counted> (i, destroyed));
+            CATCH_REQUIRE (destroyed == 0);
+        }
+        CATCH_REQUIRE (destroyed == 16);
+
+        // Following guards pick up the rest.
+        while (destroyed != 40)
+        {
+            EpochGuard const guard;
+        }
+
+        EpochGuard const guard;
+        CATCH_REQUIRE (snapshot.load ()->value == 40);
+    }
+}
+#endif // LOG4CPLUS_WITH_UNIT_TESTS
+
+
+} // namespace log4cplus::helpers
@@ -22,6 +22,7 @@
 #include <log4cplus/config.hxx>
 #if defined (LOG4CPLUS_USE_BSD_SOCKETS)
 
+#include <cstddef>
 #include <cstring>
 #include <vector>
 #include <algorithm>
@@ -36,8 +37,13 @@
 #include <sys/types.h>
 #endif
 
+#ifdef LOG4CPLUS_HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+
 #ifdef LOG4CPLUS_HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
+#include <sys/un.h>
 #endif
 
 #if defined (LOG4CPLUS_HAVE_NETINET_IN_H)
@@ -113,6 +119,36 @@ get_host_by_name (char const * hostname, std::string * name,
 }
 
 
+//! Fills `addr` with `AF_UNIX` address for `path`. Leading `@` selects
+//! Linux abstract socket namespace.
+static
+bool
+make_unix_address (tstring const & path, struct sockaddr_un & addr,
+    socklen_t & addr_len)
+{
+    std::string const path_str = LOG4CPLUS_TSTRING_TO_STRING (path);
+    if (path_str.empty () || path_str.size () >= sizeof (addr.sun_path))
+    {
+        set_last_socket_error (ENAMETOOLONG);
+        return false;
+    }
+
+    addr = sockaddr_un ();
+    addr.sun_family = AF_UNIX;
+    std::memcpy (addr.sun_path, path_str.data (), path_str.size ());
+    addr_len = static_cast<socklen_t>(
+        offsetof (struct sockaddr_un, sun_path) + path_str.size ());
+#if defined (__linux__)
+    if (addr.sun_path[0] == '@')
+        addr.sun_path[0] = '\0';
+    else
+#endif
+        addr_len += 1;
+
+    return true;
+}
+
+
 } // namespace
 
 
@@ -248,6 +284,89 @@ connectSocket(const tstring& hostn, unsigned short port, bool udp, bool ipv6,
 }
 
 
+SOCKET_TYPE
+openUnixSocket(tstring const & path, SocketState& state)
+{
+    struct sockaddr_un addr;
+    socklen_t addr_len;
+    if (! make_unix_address (path, addr, addr_len))
+        return INVALID_SOCKET_VALUE;
+
+    socket_holder sock_holder (
+        ::socket (AF_UNIX, SOCK_STREAM | TYPE_SOCK_CLOEXEC, 0));
+    if (sock_holder.sock < 0)
+        return INVALID_SOCKET_VALUE;
+
+#if ! defined (SOCK_CLOEXEC)
+    trySetCloseOnExec (sock_holder.sock);
+#endif
+
+    // Remove socket file left behind by previous server instance. A socket
+    // nobody listens on refuses connections; leave anything else at the
+    // path alone, including a socket of a server that is still running,
+    // bind() then fails on it.
+    struct stat st;
+    if (addr.sun_path[0] != '\0'
+        && ::lstat (addr.sun_path, &st) == 0
+        && S_ISSOCK (st.st_mode))
+    {
+        socket_holder probe (
+            ::socket (AF_UNIX, SOCK_STREAM | TYPE_SOCK_CLOEXEC, 0));
+        if (probe.sock >= 0)
+        {
+            int retval;
+            while ((retval = ::connect (probe.sock,
+                        reinterpret_cast<struct sockaddr *>(&addr),
+                        addr_len)) == -1
+                && errno == EINTR)
+                ;
+            if (retval == -1 && errno == ECONNREFUSED)
+                ::unlink (addr.sun_path);
+        }
+    }
+
+    if (bind (sock_holder.sock, reinterpret_cast<struct sockaddr *>(&addr),
+            addr_len) < 0)
+        return INVALID_SOCKET_VALUE;
+
+    if (::listen(sock_holder.sock, 10))
+        return INVALID_SOCKET_VALUE;
+
+    state = SocketState::ok;
+    return to_log4cplus_socket (sock_holder.detach ());
+}
+
+
+SOCKET_TYPE
+connectUnixSocket(tstring const & path, SocketState& state)
+{
+    struct sockaddr_un addr;
+    socklen_t addr_len;
+    if (! make_unix_address (path, addr, addr_len))
+        return INVALID_SOCKET_VALUE;
+
+    socket_holder sock_holder (
+        ::socket (AF_UNIX, SOCK_STREAM | TYPE_SOCK_CLOEXEC, 0));
+    if (sock_holder.sock < 0)
+        return INVALID_SOCKET_VALUE;
+
+#if ! defined (SOCK_CLOEXEC)
+    trySetCloseOnExec (sock_holder.sock);
+#endif
+
+    int retval;
+    while ((retval = ::connect (sock_holder.sock,
+                reinterpret_cast<struct sockaddr *>(&addr), addr_len)) == -1
+        && (errno == EINTR))
+        ;
+    if (retval != 0)
+        return INVALID_SOCKET_VALUE;
+
+    state = SocketState::ok;
+    return to_log4cplus_socket (sock_holder.detach ());
+}
+
+
 namespace
 {
 
@@ -518,30 +637,25 @@ setTCPNoDelay (SOCKET_TYPE sock, bool val)
 // ServerSocket OS dependent stuff
 //
 
-ServerSocket::ServerSocket(unsigned short port, bool udp /*= false*/,
-    bool ipv6 /*= false*/, tstring const & host /*= tstring ()*/)
+namespace
 {
-    // Initialize these here so that we do not try to close invalid handles
-    // in dtor if the following `openSocket()` fails.
-    interruptHandles[0] = -1;
-    interruptHandles[1] = -1;
 
+static
+bool
+open_interrupt_pipe (std::array<std::ptrdiff_t, 2> & handles)
+{
     int fds[2] = {-1, -1};
     int ret;
 
-    sock = openSocket (host, port, udp, ipv6, state);
-    if (sock == INVALID_SOCKET_VALUE)
-        goto error;
-
 #if defined (LOG4CPLUS_HAVE_PIPE2) && defined (O_CLOEXEC)
     ret = pipe2 (fds, O_CLOEXEC);
     if (ret != 0)
-        goto error;
+        return false;
 
 #elif defined (LOG4CPLUS_HAVE_PIPE)
     ret = pipe (fds);
     if (ret != 0)
-        goto error;
+        return false;
 
     trySetCloseOnExec (fds[0]);
     trySetCloseOnExec (fds[1]);
@@ -550,8 +664,25 @@ ServerSocket::ServerSocket(unsigned short port, bool udp /*= false*/,
 #  error You are missing both pipe() or pipe2().
 #endif
 
-    interruptHandles[0] = fds[0];
-    interruptHandles[1] = fds[1];
+    handles[0] = fds[0];
+    handles[1] = fds[1];
+    return true;
+}
+
+} // namespace
+
+
+ServerSocket::ServerSocket(unsigned short port, bool udp /*= false*/,
+    bool ipv6 /*= false*/, tstring const & host /*= tstring ()*/)
+    : ServerSocket (INVALID_SOCKET_VALUE, SocketState::not_opened, 0)
+{
+    sock = openSocket (host, port, udp, ipv6, state);
+    if (sock == INVALID_SOCKET_VALUE)
+        goto error;
+
+    if (! open_interrupt_pipe (interruptHandles))
+        goto error;
+
     return;
 
 error:;
@@ -559,13 +690,31 @@ error:;
     state = SocketState::not_opened;
 
     if (sock != INVALID_SOCKET_VALUE)
+    {
         closeSocket (sock);
+        sock = INVALID_SOCKET_VALUE;
+    }
+}
+
+
+ServerSocket::ServerSocket(SOCKET_TYPE sock_, SocketState state_, int err_)
+    : AbstractSocket (sock_, state_, err_)
+{
+    // Initialize these here so that we do not try to close invalid handles
+    // in dtor if the following `open_interrupt_pipe()` fails.
+    interruptHandles[0] = -1;
+    interruptHandles[1] = -1;
 
-    if (fds[0] != -1)
-        ::close (fds[0]);
+    if (sock == INVALID_SOCKET_VALUE)
+        return;
 
-    if (fds[1] != -1)
-        ::close (fds[1]);
+    if (! open_interrupt_pipe (interruptHandles))
+    {
+        err = get_last_socket_error ();
+        state = SocketState::not_opened;
+        closeSocket (sock);
+        sock = INVALID_SOCKET_VALUE;
+    }
 }
 
 Socket
@@ -286,6 +286,22 @@ connectSocket(const tstring& hostn, unsigned short port, bool udp, bool ipv6,
 }
 
 
+SOCKET_TYPE
+openUnixSocket(tstring const &, SocketState &)
+{
+    set_last_socket_error (WSAEAFNOSUPPORT);
+    return INVALID_SOCKET_VALUE;
+}
+
+
+SOCKET_TYPE
+connectUnixSocket(tstring const &, SocketState &)
+{
+    set_last_socket_error (WSAEAFNOSUPPORT);
+    return INVALID_SOCKET_VALUE;
+}
+
+
 SOCKET_TYPE
 acceptSocket(SOCKET_TYPE sock, SocketState & state)
 {
@@ -577,6 +593,7 @@ ServerSocket::ServerSocket(unsigned short port, bool udp /*= false*/,
         err = WSAGetLastError ();
         closeSocket (sock);
         sock = INVALID_SOCKET_VALUE;
+        state = SocketState::not_opened;
     }
     else
     {
@@ -586,6 +603,29 @@ ServerSocket::ServerSocket(unsigned short port, bool udp /*= false*/,
     }
 }
 
+
+ServerSocket::ServerSocket(SOCKET_TYPE sock_, SocketState state_, int err_)
+    : AbstractSocket (sock_, state_, err_)
+{
+    interruptHandles[0] = 0;
+    interruptHandles[1] = 0;
+
+    if (sock == INVALID_SOCKET_VALUE)
+        return;
+
+    HANDLE ev = WSACreateEvent ();
+    if (ev == WSA_INVALID_EVENT)
+    {
+        err = WSAGetLastError ();
+        closeSocket (sock);
+        sock = INVALID_SOCKET_VALUE;
+        state = SocketState::not_opened;
+    }
+    else
+        interruptHandles[0] = reinterpret_cast<std::ptrdiff_t>(ev);
+}
+
+
 Socket
 ServerSocket::accept ()
 {
@@ -23,6 +23,9 @@
 #include <log4cplus/internal/internal.h>
 
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <log4cplus/internal/env.h>
+#include <log4cplus/helpers/stringhelper.h>
+#include <cstdio>
 #include <catch_amalgamated.hpp>
 #endif
 
@@ -225,10 +228,30 @@ Socket::write(const std::string & buffer)
 }
 
 
+Socket
+Socket::connectUnix (const tstring& path)
+{
+    SocketState st = SocketState::not_opened;
+    SOCKET_TYPE const s = connectUnixSocket (path, st);
+    int const eno = s == INVALID_SOCKET_VALUE ? get_last_socket_error () : 0;
+    return Socket (s, st, eno);
+}
+
+
 //
 //
 //
 
+ServerSocket
+ServerSocket::listenUnix (const tstring& path)
+{
+    SocketState st = SocketState::not_opened;
+    SOCKET_TYPE const s = openUnixSocket (path, st);
+    int const eno = s == INVALID_SOCKET_VALUE ? get_last_socket_error () : 0;
+    return ServerSocket (s, st, eno);
+}
+
+
 ServerSocket::ServerSocket (ServerSocket && other) LOG4CPLUS_NOEXCEPT
     : AbstractSocket (std::move (other))
 {
@@ -283,6 +306,63 @@ CATCH_TEST_CASE ("Socket", "[sockets]")
             CATCH_REQUIRE (result.has_value ());
         }
     }
+
+#if defined (LOG4CPLUS_USE_BSD_SOCKETS)
+    CATCH_SECTION ("local stream socket")
+    {
+        tstring tmp_dir;
+        if (! internal::get_env_var (tmp_dir, LOG4CPLUS_TEXT ("TMPDIR"))
+            || tmp_dir.empty ())
+            tmp_dir = LOG4CPLUS_TEXT ("/tmp");
+        tstring const path = tmp_dir
+            + LOG4CPLUS_TEXT ("/log4cplus-unit-test-")
+            + convertIntegerToString (internal::get_process_id ())
+            + LOG4CPLUS_TEXT (".sock");
+
+        struct remove_socket_file
+        {
+            ~remove_socket_file ()
+            {
+                std::remove (LOG4CPLUS_TSTRING_TO_STRING (path).c_str ());
+            }
+
+            tstring const & path;
+        } const remove_guard {path};
+
+        ServerSocket server = ServerSocket::listenUnix (path);
+        CATCH_REQUIRE (server.isOpen ());
+
+        Socket client = Socket::connectUnix (path);
+        CATCH_REQUIRE (client.isOpen ());
+
+        Socket peer = server.accept ();
+        CATCH_REQUIRE (peer.isOpen ());
+
+        SocketBuffer out (sizeof (unsigned int));
+        out.appendInt (0x12345678u);
+        CATCH_REQUIRE (client.write (out));
+
+        SocketBuffer in (sizeof (unsigned int));
+        CATCH_REQUIRE (peer.read (in));
+        CATCH_REQUIRE (in.readInt () == 0x12345678u);
+
+        // Socket of a running server is not taken over, a stale one is.
+        CATCH_REQUIRE (! ServerSocket::listenUnix (path).isOpen ());
+        server.close ();
+        CATCH_REQUIRE (ServerSocket::listenUnix (path).isOpen ());
+
+        // Only a stale socket file is replaced, not other files.
+        std::string const narrow_path = LOG4CPLUS_TSTRING_TO_STRING (path);
+        std::remove (narrow_path.c_str ());
+        std::FILE * file = std::fopen (narrow_path.c_str (), "w");
+        CATCH_REQUIRE (file);
+        std::fclose (file);
+        CATCH_REQUIRE (! ServerSocket::listenUnix (path).isOpen ());
+        file = std::fopen (narrow_path.c_str (), "r");
+        CATCH_REQUIRE (file);
+        std::fclose (file);
+    }
+#endif
 }
 #endif // LOG4CPLUS_WITH_UNIT_TESTS
 
@@ -59,6 +59,16 @@ SocketAppender::SocketAppender(const helpers::Properties & properties)
     properties.getUInt (port, LOG4CPLUS_TEXT("port"));
     serverName = properties.getProperty( LOG4CPLUS_TEXT("ServerName") );
     properties.getBool(ipv6, LOG4CPLUS_TEXT("IPv6"));
+    unixSocket = properties.getProperty( LOG4CPLUS_TEXT("UnixSocket") );
+    properties.getBool(sharedMemory, LOG4CPLUS_TEXT("SharedMemory"));
+    properties.getUInt(sharedMemorySize, LOG4CPLUS_TEXT("SharedMemorySize"));
+    if (sharedMemory && unixSocket.empty ())
+    {
+        helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("SocketAppender- SharedMemory requires")
+            LOG4CPLUS_TEXT(" UnixSocket, using plain socket instead"));
+        sharedMemory = false;
+    }
 
     openSocket();
     initConnector ();
@@ -87,6 +97,7 @@ SocketAppender::close()
     connector->terminate ();
 #endif
 
+    ring.close();
     socket.close();
     closed = true;
 }
@@ -101,11 +112,44 @@ void
 SocketAppender::openSocket()
 {
     if(!socket.isOpen()) {
-        socket = helpers::Socket(host, static_cast<unsigned short>(port), false, ipv6);
+        socket = connectToServer ();
+        ring = offerSharedMemory (socket);
     }
 }
 
 
+helpers::Socket
+SocketAppender::connectToServer () const
+{
+    if (! unixSocket.empty ())
+        return helpers::Socket::connectUnix (unixSocket);
+    else
+        return helpers::Socket (host, static_cast<unsigned short>(port),
+            false, ipv6);
+}
+
+
+helpers::SharedMemoryRing
+SocketAppender::offerSharedMemory (helpers::Socket & sock) const
+{
+    if (! sharedMemory || ! sock.isOpen ())
+        return helpers::SharedMemoryRing ();
+
+    helpers::SharedMemoryRing new_ring (
+        helpers::SharedMemoryRing::offer (sock, sharedMemorySize));
+    if (! new_ring.isOpen ())
+    {
+        // Do not fall back to writing into the socket, the collector
+        // on the other side expects the ring.
+        helpers::getLogLog().error(
+            LOG4CPLUS_TEXT("SocketAppender- Cannot offer shared memory"));
+        sock.close ();
+    }
+
+    return new_ring;
+}
+
+
 void
 SocketAppender::initConnector ()
 {
@@ -151,10 +195,26 @@ SocketAppender::append(const spi::InternalLoggingEvent& event)
         return;
     }
 
-    helpers::SocketBuffer buffer(sizeof(unsigned int));
-    buffer.appendInt(static_cast<unsigned>(msgBuffer.getSize()));
+    bool ret;
+    if (sharedMemory)
+    {
+        // Records in the ring carry their own length.
+        helpers::SocketBuffer const * const buffers[] = {&msgBuffer};
+        ret = ring.write (1, buffers);
+        if (! ret)
+        {
+            ring.close ();
+            socket.close ();
+        }
+    }
+    else
+    {
+        helpers::SocketBuffer buffer(sizeof(unsigned int));
+        buffer.appendInt(static_cast<unsigned>(msgBuffer.getSize()));
+
+        ret = helpers::Socket::write(socket, buffer, msgBuffer);
+    }
 
-    bool ret = helpers::Socket::write(socket, buffer, msgBuffer);
     if (! ret)
     {
         helpers::getLogLog().error(
@@ -187,12 +247,15 @@ SocketAppender::ctcGetSocket ()
 helpers::Socket
 SocketAppender::ctcConnect ()
 {
-    return helpers::Socket (host, static_cast<unsigned short>(port));
+    helpers::Socket new_socket (connectToServer ());
+    pendingRing = offerSharedMemory (new_socket);
+    return new_socket;
 }
 
 void
 SocketAppender::ctcSetConnected ()
 {
+    ring = std::move (pendingRing);
     connected = true;
 }
 
@@ -59,9 +59,20 @@ SocketBuffer::SocketBuffer(std::size_t maxsize_)
 }
 
 
+SocketBuffer::SocketBuffer(char * data, std::size_t size_)
+: maxsize(size_),
+  size(size_),
+  pos(0),
+  buffer(data),
+  owner(false)
+{
+}
+
+
 SocketBuffer::~SocketBuffer()
 {
-    delete [] buffer;
+    if (owner)
+        delete [] buffer;
 }
 
 
@@ -29,6 +29,8 @@
 #include <cwctype>
 #include <cctype>
 #include <cassert>
+#include <mutex>
+#include <unordered_map>
 
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
 #include <catch_amalgamated.hpp>
@@ -240,6 +242,86 @@ toLower(const tstring_view& s)
 }
 
 
+namespace
+{
+
+
+struct intern_pool
+{
+    //! Each shard has its own lock so that interning unrelated names
+    //! from many threads does not serialize on a single mutex.
+    struct shard
+    {
+        std::mutex mtx;
+        std::unordered_map<tstring_view, std::weak_ptr<tstring const>> strings;
+    };
+
+    static constexpr std::size_t shard_count = 16;
+
+    shard &
+    get_shard (tstring_view const & s)
+    {
+        return shards[std::hash<tstring_view> () (s) % shard_count];
+    }
+
+    shard shards[shard_count];
+};
+
+
+//! The pool is never destroyed so that interned strings can be safely
+//! released even during static destruction.
+intern_pool &
+get_intern_pool ()
+{
+    static intern_pool * const pool = new intern_pool;
+    return *pool;
+}
+
+
+struct interned_string_deleter
+{
+    void
+    operator () (tstring const * str) const
+    {
+        intern_pool::shard & shard = get_intern_pool ().get_shard (*str);
+        {
+            std::lock_guard guard (shard.mtx);
+
+            // The entry might have been replaced by a new instance of
+            // the same string already.
+            auto it = shard.strings.find (*str);
+            if (it != shard.strings.end () && it->first.data () == str->data ())
+                shard.strings.erase (it);
+        }
+
+        delete str;
+    }
+};
+
+
+} // namespace
+
+
+SharedTString
+internString (const tstring_view& s)
+{
+    intern_pool::shard & shard = get_intern_pool ().get_shard (s);
+    std::lock_guard guard (shard.mtx);
+
+    if (auto it = shard.strings.find (s); it != shard.strings.end ())
+    {
+        if (SharedTString existing = it->second.lock ())
+            return existing;
+
+        shard.strings.erase (it);
+    }
+
+    SharedTString str (new tstring (s), interned_string_deleter ());
+    shard.strings.emplace (tstring_view (*str), str);
+    return str;
+}
+
+
 #if defined (LOG4CPLUS_WITH_UNIT_TESTS)
 
 namespace
@@ -510,6 +592,16 @@ CATCH_TEST_CASE( "Strings helpers", "[strings]" )
             CATCH_REQUIRE (result == LOG4CPLUS_TEXT ("1,2,3"));
         }
     }
+
+    CATCH_SECTION ("internString")
+    {
+        SharedTString const a = internString (LOG4CPLUS_TEXT ("interned"));
+        SharedTString const b = internString (tstring (LOG4CPLUS_TEXT ("interned")));
+        CATCH_REQUIRE (*a == LOG4CPLUS_TEXT ("interned"));
+        CATCH_REQUIRE (a.get () == b.get ());
+        CATCH_REQUIRE (internString (LOG4CPLUS_TEXT ("other")).get ()
+            != a.get ());
+    }
 }
 #endif
 
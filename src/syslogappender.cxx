@@ -28,6 +28,14 @@
 #include <log4cplus/thread/syncprims-pub-impl.h>
 #include <cstring>
 
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+#include <log4cplus/hierarchy.h>
+#include <log4cplus/layout.h>
+#include <log4cplus/nullappender.h>
+#include <log4cplus/helpers/socketbuffer.h>
+#include <catch_amalgamated.hpp>
+#endif
+
 #if defined (LOG4CPLUS_HAVE_SYSLOG_H)
 #include <syslog.h>
 
@@ -356,6 +364,14 @@ SysLogAppender::close()
 }
 
 
+unsigned
+SysLogAppender::getEventFields() const
+{
+    // Remote syslog messages carry time stamp of the event.
+    return getLayoutEventFields () | spi::EVENT_FIELD_TIMESTAMP;
+}
+
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // SysLogAppender protected methods
@@ -400,7 +416,7 @@ SysLogAppender::appendLocal(const spi::InternalLoggingEvent& event)
     int const level = getSysLogLevel(event.getLogLevel());
     internal::appender_sratch_pad & appender_sp = internal::get_appender_sp ();
     detail::clear_tostringstream (appender_sp.oss);
-    layout->formatAndAppend(appender_sp.oss, event);
+    formatAndAppend(appender_sp.oss, event);
     appender_sp.str = appender_sp.oss.str ();
     ::syslog(facility | level, "%s",
         LOG4CPLUS_TSTRING_TO_STRING(appender_sp.str).c_str());
@@ -463,7 +479,7 @@ SysLogAppender::appendRemote(const spi::InternalLoggingEvent& event)
         << LOG4CPLUS_TEXT (" - ");
 
     // MSG
-    layout->formatAndAppend (appender_sp.oss, event);
+    formatAndAppend (appender_sp.oss, event);
 
     appender_sp.chstr = LOG4CPLUS_TSTRING_TO_STRING (appender_sp.oss.str ());
 
@@ -552,4 +568,64 @@ SysLogAppender::openSocket ()
 }
 
 
+#if defined (LOG4CPLUS_WITH_UNIT_TESTS)
+CATCH_TEST_CASE ("SysLogAppender", "[appenders]")
+{
+    CATCH_SECTION ("layout output shared with another appender")
+    {
+        tstring const localhost (LOG4CPLUS_TEXT ("127.0.0.1"));
+        unsigned short port = 45140;
+        helpers::ServerSocket server (port, false, false, localhost);
+        while (! server.isOpen () && port != 45240)
+            server = helpers::ServerSocket (++port, false, false, localhost);
+        CATCH_REQUIRE (server.isOpen ());
+
+        Hierarchy h;
+        Logger logger = h.getInstance (LOG4CPLUS_TEXT ("syslog"));
+
+        // Both appenders have the same layout key, so the first one to
+        // format the event shares its output with the other.
+        SharedAppenderPtr null_app (new NullAppender);
+        null_app->setLayout (
+            std::make_unique<PatternLayout> (LOG4CPLUS_TEXT ("%m")));
+        logger.addAppender (null_app);
+
+        SharedAppenderPtr syslog_app (new SysLogAppender (
+            LOG4CPLUS_TEXT ("test"), localhost, port, LOG4CPLUS_TEXT ("user"),
+            SysLogAppender::RSTTcp));
+        syslog_app->setLayout (
+            std::make_unique<PatternLayout> (LOG4CPLUS_TEXT ("%m")));
+        logger.addAppender (syslog_app);
+
+        helpers::Socket peer = server.accept ();
+        CATCH_REQUIRE (peer.isOpen ());
+
+        logger.log (INFO_LOG_LEVEL, LOG4CPLUS_TEXT ("hello"));
+
+        // Octet counting framing: length, space, message.
+        std::size_t length = 0;
+        for (;;)
+        {
+            helpers::SocketBuffer digit (1);
+            CATCH_REQUIRE (peer.read (digit));
+            char const ch = static_cast<char>(digit.readByte ());
+            if (ch == ' ')
+                break;
+            length = length * 10 + (ch - '0');
+        }
+
+        helpers::SocketBuffer frame (length);
+        CATCH_REQUIRE (peer.read (frame));
+        std::string const message (frame.getBuffer (), length);
+        CATCH_REQUIRE (message.compare (0, 4, "<14>") == 0);
+        CATCH_REQUIRE (message.size () > 8);
+        CATCH_REQUIRE (message.compare (message.size () - 8, 8, " - hello")
+            == 0);
+
+        h.shutdown ();
+    }
+}
+#endif // LOG4CPLUS_WITH_UNIT_TESTS
+
+
 } // namespace log4cplus
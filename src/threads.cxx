@@ -192,6 +192,7 @@ LOG4CPLUS_EXPORT void setCurrentThreadName(const log4cplus::tstring & name)
 #else
     thread_name = name;
 #endif
+    log4cplus::internal::get_ptd ()->thread_name_handle.reset ();
 }
 
 LOG4CPLUS_EXPORT void setCurrentThreadName2(const log4cplus::tstring & name)
@@ -201,6 +202,7 @@ LOG4CPLUS_EXPORT void setCurrentThreadName2(const log4cplus::tstring & name)
 #else
     thread_name2 = name;
 #endif
+    log4cplus::internal::get_ptd ()->thread_name2_handle.reset ();
 }
 
 
@@ -314,3 +316,33 @@ AbstractThread::~AbstractThread()
 
 
 } // namespace log4cplus::thread
+
+
+namespace log4cplus::internal {
+
+
+helpers::SharedTString const &
+get_thread_name_handle ()
+{
+    per_thread_data * const ptd = get_ptd ();
+    if (! ptd->thread_name_handle) [[unlikely]]
+        ptd->thread_name_handle
+            = helpers::internString (thread::getCurrentThreadName ());
+
+    return ptd->thread_name_handle;
+}
+
+
+helpers::SharedTString const &
+get_thread_name2_handle ()
+{
+    per_thread_data * const ptd = get_ptd ();
+    if (! ptd->thread_name2_handle) [[unlikely]]
+        ptd->thread_name2_handle
+            = helpers::internString (thread::getCurrentThreadName2 ());
+
+    return ptd->thread_name2_handle;
+}
+
+
+} // namespace log4cplus::internal
@@ -5,8 +5,14 @@
 #include <log4cplus/helpers/stringhelper.h>
 #include <log4cplus/helpers/timehelper.h>
 #include <log4cplus/helpers/fileinfo.h>
+#include <log4cplus/helpers/property.h>
+#include <log4cplus/spi/filter.h>
 #include <log4cplus/spi/loggingevent.h>
+#include <log4cplus/hierarchy.h>
 #include <log4cplus/initializer.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
 
 
 using namespace std;
@@ -24,6 +30,12 @@ log4cplus::tostream& operator <<(log4cplus::tostream& s, const Time& t)
 
 
 #define LOOP_COUNT 100000
+// Override with LOG4CPLUS_PERF_LOGGER_COUNT environment variable, e.g.,
+// to 1000000, to benchmark really large hierarchies.
+#define LOGGER_COUNT 10000
+#define FILTER_STRING_COUNT 300
+#define APPENDER_COUNT 200
+#define GENERATED_APPENDER_COUNT 4000
 
 
 log4cplus::tstring
@@ -42,6 +54,17 @@ getPropertiesFileArgument (int argc, char * argv[])
 }
 
 
+int
+getLoggerCount ()
+{
+    if (char const * count = std::getenv ("LOG4CPLUS_PERF_LOGGER_COUNT"))
+        if (int const value = std::atoi (count); value > 0)
+            return value;
+
+    return LOGGER_COUNT;
+}
+
+
 int
 main(int argc, char * argv[])
 {
@@ -136,6 +159,183 @@ main(int argc, char * argv[])
                        << diff_seconds);
         LOG4CPLUS_WARN(root, "getThread() average: "
                        << (diff_seconds/LOOP_COUNT) << endl);
+
+        // Hundreds of strings to drop: chain of StringMatchFilter vs.
+        // single MultiStringMatchFilter.
+        {
+            std::vector<tstring> strings;
+            spi::FilterPtr chain;
+            for(i=0; i<FILTER_STRING_COUNT; ++i) {
+                strings.push_back (LOG4CPLUS_TEXT ("noisy message #")
+                    + convertIntegerToString (i));
+
+                Properties props;
+                props.setProperty (LOG4CPLUS_TEXT ("StringToMatch"),
+                    strings.back ());
+                props.setProperty (LOG4CPLUS_TEXT ("AcceptOnMatch"),
+                    LOG4CPLUS_TEXT ("false"));
+                spi::FilterPtr f (new spi::StringMatchFilter (props));
+                if (chain)
+                    chain->appendFilter (f);
+                else
+                    chain = f;
+            }
+            spi::MultiStringMatchFilter const multi (strings, false);
+
+            log4cplus::spi::InternalLoggingEvent const e(logger.getName(),
+                log4cplus::WARN_LOG_LEVEL,
+                LOG4CPLUS_TEXT ("This is a WARNING about message #12 which ")
+                LOG4CPLUS_TEXT ("is not noisy at all..."),
+                __FILE__, __LINE__, "main");
+
+            start = hr_clock::now ();
+            for(i=0; i<LOOP_COUNT; ++i) {
+                spi::checkFilter (chain.get (), e);
+            }
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "Chain of " << FILTER_STRING_COUNT
+                           << " StringMatchFilters average: "
+                           << (diff_seconds/LOOP_COUNT));
+
+            start = hr_clock::now ();
+            for(i=0; i<LOOP_COUNT; ++i) {
+                spi::checkFilter (&multi, e);
+            }
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "MultiStringMatchFilter with "
+                           << FILTER_STRING_COUNT << " strings average: "
+                           << (diff_seconds/LOOP_COUNT) << endl);
+        }
+
+        // Startup of a process whose file appenders receive no events:
+        // configuration and shutdown with eager vs. lazy activation.
+        for (tstring const & activation : { tstring (LOG4CPLUS_TEXT ("Eager")),
+                tstring (LOG4CPLUS_TEXT ("Lazy")) }) {
+            Properties props;
+            for(i=0; i<APPENDER_COUNT; ++i) {
+                tstring const appender = LOG4CPLUS_TEXT ("A")
+                    + convertIntegerToString (i);
+                tstring const prefix = LOG4CPLUS_TEXT ("log4cplus.appender.")
+                    + appender;
+                props.setProperty (prefix,
+                    LOG4CPLUS_TEXT ("log4cplus::FileAppender"));
+                props.setProperty (prefix + LOG4CPLUS_TEXT (".File"),
+                    LOG4CPLUS_TEXT ("startup-test-")
+                    + convertIntegerToString (i) + LOG4CPLUS_TEXT (".log"));
+                props.setProperty (prefix + LOG4CPLUS_TEXT (".Activation"),
+                    activation);
+                props.setProperty (LOG4CPLUS_TEXT ("log4cplus.logger.startup.")
+                    + convertIntegerToString (i),
+                    LOG4CPLUS_TEXT ("OFF, ") + appender);
+            }
+
+            start = hr_clock::now ();
+            {
+                Hierarchy hierarchy;
+                PropertyConfigurator (props, hierarchy).configure ();
+            }
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, activation << " activation of "
+                           << APPENDER_COUNT << " file appenders took: "
+                           << diff_seconds);
+
+            for(i=0; i<APPENDER_COUNT; ++i) {
+                std::remove ((std::string ("startup-test-")
+                    + std::to_string (i) + ".log").c_str ());
+            }
+        }
+
+        // Large generated configuration, 5 keys per appender.
+        {
+            Properties props;
+            for(i=0; i<GENERATED_APPENDER_COUNT; ++i) {
+                tstring const appender = LOG4CPLUS_TEXT ("N")
+                    + convertIntegerToString (i);
+                tstring const prefix = LOG4CPLUS_TEXT ("log4cplus.appender.")
+                    + appender;
+                props.setProperty (prefix,
+                    LOG4CPLUS_TEXT ("log4cplus::NullAppender"));
+                props.setProperty (prefix + LOG4CPLUS_TEXT (".layout"),
+                    LOG4CPLUS_TEXT ("log4cplus::PatternLayout"));
+                props.setProperty (
+                    prefix + LOG4CPLUS_TEXT (".layout.ConversionPattern"),
+                    LOG4CPLUS_TEXT ("${LOG4CPLUS_PERF_PREFIX}%p %c - %m%n"));
+                props.setProperty (prefix + LOG4CPLUS_TEXT (".Threshold"),
+                    LOG4CPLUS_TEXT ("INFO"));
+                props.setProperty (LOG4CPLUS_TEXT ("log4cplus.logger.generated.")
+                    + convertIntegerToString (i),
+                    LOG4CPLUS_TEXT ("INFO, ") + appender);
+            }
+
+            Hierarchy hierarchy;
+            start = hr_clock::now ();
+            PropertyConfigurator (props, hierarchy).configure ();
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "Configuring " << props.size ()
+                           << " generated properties took: " << diff_seconds);
+
+            start = hr_clock::now ();
+            for(i=0; i<GENERATED_APPENDER_COUNT; ++i) {
+                props.getPropertySubset (LOG4CPLUS_TEXT ("log4cplus.appender.N")
+                    + convertIntegerToString (i) + LOG4CPLUS_TEXT ("."));
+            }
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "getPropertySubset() average: "
+                           << (diff_seconds/GENERATED_APPENDER_COUNT) << endl);
+        }
+
+        // Per-entity loggers, e.g., "entities.group12.entity12345".
+        int const loggerCount = getLoggerCount ();
+        std::vector<tstring> loggerNames;
+        loggerNames.reserve (loggerCount);
+        for(i=0; i<loggerCount; ++i) {
+            loggerNames.push_back (LOG4CPLUS_TEXT ("entities.group")
+                + convertIntegerToString (i % 1000)
+                + LOG4CPLUS_TEXT (".entity") + convertIntegerToString (i));
+        }
+
+        {
+            Hierarchy hierarchy;
+            start = hr_clock::now ();
+            for (tstring const & name : loggerNames)
+                hierarchy.getInstance (name);
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "Creating " << loggerCount
+                           << " loggers took: " << diff_seconds);
+
+            start = hr_clock::now ();
+            for (tstring const & name : loggerNames)
+                hierarchy.getInstance (name);
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "Looking up " << loggerCount
+                           << " existing loggers took: " << diff_seconds);
+        }
+
+        {
+            Hierarchy hierarchy;
+            start = hr_clock::now ();
+            LoggerList loggers = hierarchy.getInstances (loggerNames);
+            end = hr_clock::now ();
+            diff = end - start;
+            diff_seconds = sec_dur_type (diff).count ();
+            LOG4CPLUS_WARN(root, "Creating " << loggers.size ()
+                           << " loggers in bulk took: " << diff_seconds
+                           << endl);
+        }
     }
     catch(...) {
         tcout << LOG4CPLUS_TEXT("Exception...") << endl;